@@ -6,45 +6,544 @@ const Color colors[COLORS_AMOUNT] = {
         BEIGE, SKYBLUE, MAROON, VIOLET
 };
 
-void init(void)
+typedef struct
 {
-    InitWindow(WIDTH, HEIGHT, "@eesuck");
-    SetTargetFPS(NO_ANIMATION_FPS);
+    size_t functions_amount;
+    function_type* functions;
+    double start;
+    double end;
+} NCPlotSource; // NumC Plot source structure that contain: functions and the range they are drawn on
+
+typedef struct
+{
+    double x;
+    double y;
+} NCScatterPoint; // NumC Scatter point structure that contain: point coordinates
+
+typedef struct
+{
+    const double* X;
+    const double* Y;
+    size_t amount;
+    NCScatterPoint* sorted;
+} NCScatterSource; // NumC Scatter source structure that contain: points and their copy sorted by x, made by the tile thread on first use
+
+static double viewport_scale(long level)
+{
+    return pow(PLOT_ZOOM_STEP, (double)level);
 }
 
-void plot(const double start, const double end, size_t functions_amount, function_type* functions)
+static double tile_width(long level)
 {
-    init();
+    return PLOT_TILE_PIXELS / viewport_scale(level);
+}
+
+// screen position of a world point, clamped a window away from the screen so far points stay drawable
+static Vector2 viewport_to_screen(NCViewport viewport, double x, double y)
+{
+    double scale = viewport_scale(viewport.level);
+    double column = (x - viewport.left) * scale;
+    double row = HEIGHT - (y - viewport.bottom) * scale;
 
-    double* X = linspace(start, end, ARRAY_SIZE);
-    double** Y = (double**)malloc(sizeof(double*) * functions_amount);
+    column = column < -WIDTH ? -WIDTH : column > 2.0 * WIDTH ? 2.0 * WIDTH : column;
+    row = row < -HEIGHT ? -HEIGHT : row > 2.0 * HEIGHT ? 2.0 * HEIGHT : row;
+
+    return (Vector2){ (float)column, (float)row };
+}
+
+static void viewport_update(NCViewport* viewport, NCViewport initial)
+{
+    double scale = viewport_scale(viewport->level);
+    float wheel = GetMouseWheelMove();
 
-    for (size_t function_index = 0; function_index < functions_amount; function_index++)
+    if (wheel != 0)
     {
-        Y[function_index] = apply_to_array(X, ARRAY_SIZE, functions[function_index]);
+        Vector2 mouse = GetMousePosition();
+        double x = viewport->left + mouse.x / scale;
+        double y = viewport->bottom + (HEIGHT - mouse.y) / scale;
+        long level = viewport->level + (wheel > 0 ? 1 : -1);
+
+        if (level >= -PLOT_ZOOM_LEVELS && level <= PLOT_ZOOM_LEVELS)
+        {
+            viewport->level = level;
+            scale = viewport_scale(level);
+
+            // keep the point under the cursor in place
+            viewport->left = x - mouse.x / scale;
+            viewport->bottom = y - (HEIGHT - mouse.y) / scale;
+        }
     }
 
-    while(!WindowShouldClose())
+    if (IsMouseButtonDown(MOUSE_BUTTON_LEFT))
     {
-        BeginDrawing();
-        ClearBackground(RAYWHITE);
+        Vector2 delta = GetMouseDelta();
+
+        viewport->left -= delta.x / scale;
+        viewport->bottom += delta.y / scale;
+    }
 
-        for (size_t function_index = 0; function_index < functions_amount; function_index++)
+    if (IsKeyPressed(KEY_R))
+    {
+        *viewport = initial;
+    }
+}
+
+static void viewport_draw_axes(NCViewport viewport)
+{
+    Vector2 origin = viewport_to_screen(viewport, 0, 0);
+
+    if (origin.x >= 0 && origin.x < WIDTH)
+    {
+        DrawLine((int)origin.x, 0, (int)origin.x, HEIGHT, LIGHTGRAY);
+    }
+
+    if (origin.y >= 0 && origin.y < HEIGHT)
+    {
+        DrawLine(0, (int)origin.y, WIDTH, (int)origin.y, LIGHTGRAY);
+    }
+}
+
+static void tile_release(NCTileCache* cache, NCTile* tile)
+{
+    if (tile->state == TILE_READY)
+    {
+        for (size_t series = 0; series < cache->series_amount; ++series)
+        {
+            samples_delete(tile->samples[series]);
+        }
+
+        NC_FREE(tile->samples);
+    }
+
+    tile->state = TILE_EMPTY;
+    tile->samples = NULL;
+}
+
+// the cache mutex must be held
+static NCTile* tile_cache_find(NCTileCache* cache, long level, long index)
+{
+    for (size_t i = 0; i < PLOT_TILE_CACHE; ++i)
+    {
+        NCTile* tile = &cache->tiles[i];
+
+        if (tile->state != TILE_EMPTY && tile->level == level && tile->index == index)
         {
-            for (size_t point = 0; point < ARRAY_SIZE; point++)
+            return tile;
+        }
+    }
+
+    return NULL;
+}
+
+// takes a free slot or the least recently shown tile not wanted this frame, the cache mutex must be held
+static void tile_cache_request(NCTileCache* cache, long level, long index)
+{
+    NCTile* victim = NULL;
+
+    for (size_t i = 0; i < PLOT_TILE_CACHE; ++i)
+    {
+        NCTile* tile = &cache->tiles[i];
+
+        if (tile->state == TILE_EMPTY)
+        {
+            victim = tile;
+            break;
+        }
+
+        if (tile->state != TILE_WORKING && tile->shown < cache->frame && (victim == NULL || tile->shown < victim->shown))
+        {
+            victim = tile;
+        }
+    }
+
+    if (victim == NULL)
+    {
+        return;
+    }
+
+    tile_release(cache, victim);
+
+    victim->state = TILE_PENDING;
+    victim->level = level;
+    victim->index = index;
+    victim->shown = cache->frame;
+}
+
+// the most recently wanted request, the cache mutex must be held
+static NCTile* tile_cache_next(NCTileCache* cache)
+{
+    NCTile* next = NULL;
+
+    for (size_t i = 0; i < PLOT_TILE_CACHE; ++i)
+    {
+        NCTile* tile = &cache->tiles[i];
+
+        if (tile->state == TILE_PENDING && (next == NULL || tile->shown > next->shown))
+        {
+            next = tile;
+        }
+    }
+
+    return next;
+}
+
+static void* tile_cache_worker(void* argument)
+{
+    NCTileCache* cache = argument;
+
+    pthread_mutex_lock(&cache->mutex);
+
+    for (;;)
+    {
+        NCTile* tile = NULL;
+
+        while (!cache->stopping && (tile = tile_cache_next(cache)) == NULL)
+        {
+            pthread_cond_wait(&cache->wake, &cache->mutex);
+        }
+
+        if (cache->stopping)
+        {
+            break;
+        }
+
+        tile->state = TILE_WORKING;
+
+        long level = tile->level;
+        double width = tile_width(level);
+        double start = (double)tile->index * width;
+
+        pthread_mutex_unlock(&cache->mutex);
+
+        NCSamples* samples = NC_MALLOC(sizeof(*samples) * cache->series_amount, "plot");
+        assert(samples != NULL);
+
+        cache->producer(cache->source, start, start + width, viewport_scale(level), samples);
+
+        pthread_mutex_lock(&cache->mutex);
+
+        tile->samples = samples;
+        tile->state = TILE_READY;
+    }
+
+    pthread_mutex_unlock(&cache->mutex);
+
+    return NULL;
+}
+
+static void tile_cache_start(NCTileCache* cache, tile_producer_type producer, void* source, size_t series_amount)
+{
+    cache->producer = producer;
+    cache->source = source;
+    cache->series_amount = series_amount;
+    cache->stopping = 0;
+    cache->frame = 0;
+
+    for (size_t i = 0; i < PLOT_TILE_CACHE; ++i)
+    {
+        cache->tiles[i].state = TILE_EMPTY;
+        cache->tiles[i].samples = NULL;
+    }
+
+    pthread_mutex_init(&cache->mutex, NULL);
+    pthread_cond_init(&cache->wake, NULL);
+
+    int created = pthread_create(&cache->thread, NULL, tile_cache_worker, cache);
+    assert((created == 0) && "Failed to create tile thread");
+}
+
+static void tile_cache_stop(NCTileCache* cache)
+{
+    pthread_mutex_lock(&cache->mutex);
+    cache->stopping = 1;
+    pthread_cond_signal(&cache->wake);
+    pthread_mutex_unlock(&cache->mutex);
+
+    pthread_join(cache->thread, NULL);
+
+    for (size_t i = 0; i < PLOT_TILE_CACHE; ++i)
+    {
+        tile_release(cache, &cache->tiles[i]);
+    }
+
+    pthread_mutex_destroy(&cache->mutex);
+    pthread_cond_destroy(&cache->wake);
+}
+
+static void tile_draw(NCTileCache* cache, NCTile* tile, NCViewport viewport, int lines)
+{
+    tile->shown = cache->frame;
+
+    for (size_t series = 0; series < cache->series_amount; ++series)
+    {
+        NCSamples samples = tile->samples[series];
+
+        for (size_t point = 0; point < samples.length; ++point)
+        {
+            Vector2 position = viewport_to_screen(viewport, samples.X[point], samples.Y[point]);
+
+            if (!lines)
             {
-                DrawPixel((int)X[point] + WIDTH / 2,
-                          (int)-Y[function_index][point] + HEIGHT / 2,
-                          colors[function_index % COLORS_AMOUNT]);
+                DrawCircle((int)position.x, (int)position.y, SCATTER_RADIUS, BASIC_COLOR);
+            }
+            else if (point + 1 < samples.length && samples.connected[point])
+            {
+                Vector2 next = viewport_to_screen(viewport, samples.X[point + 1], samples.Y[point + 1]);
 
-                DrawPixel((int)X[point] + WIDTH / 2,
-                          (int)-Y[function_index][point] + HEIGHT / 2 + 1,
-                          colors[function_index % COLORS_AMOUNT]);
+                DrawLineEx(position, next, PLOT_LINE_THICKNESS, colors[series % COLORS_AMOUNT]);
             }
         }
+    }
+}
+
+// draws cached tiles of the closest zoom level that overlap [start, end), the cache mutex must be held
+static void tile_cache_draw_fallback(NCTileCache* cache, NCViewport viewport, double start, double end, int lines)
+{
+    long best = 0;
+    int found = 0;
+
+    for (size_t i = 0; i < PLOT_TILE_CACHE; ++i)
+    {
+        NCTile* tile = &cache->tiles[i];
+        double width = tile_width(tile->level);
+        double tile_start = (double)tile->index * width;
+
+        if (tile->state == TILE_READY && tile->level != viewport.level && tile_start < end && tile_start + width > start &&
+            (!found || labs(tile->level - viewport.level) < labs(best - viewport.level)))
+        {
+            best = tile->level;
+            found = 1;
+        }
+    }
+
+    for (size_t i = 0; found && i < PLOT_TILE_CACHE; ++i)
+    {
+        NCTile* tile = &cache->tiles[i];
+        double width = tile_width(tile->level);
+        double tile_start = (double)tile->index * width;
+
+        if (tile->state == TILE_READY && tile->level == best && tile_start < end && tile_start + width > start)
+        {
+            tile_draw(cache, tile, viewport, lines);
+        }
+    }
+}
+
+// draws the tiles covering the viewport and requests missing ones, never waits for the tile thread to produce
+static void tile_cache_draw(NCTileCache* cache, NCViewport viewport, int lines)
+{
+    double width = tile_width(viewport.level);
+    long first = (long)floor(viewport.left / width);
+    long last = (long)floor((viewport.left + WIDTH / viewport_scale(viewport.level)) / width);
+    int requested = 0;
+
+    pthread_mutex_lock(&cache->mutex);
+
+    cache->frame += 1;
+
+    // every visible tile is marked before any request, so a request never evicts a tile wanted this frame
+    for (long index = first; index <= last; ++index)
+    {
+        NCTile* tile = tile_cache_find(cache, viewport.level, index);
+
+        if (tile != NULL)
+        {
+            tile->shown = cache->frame;
+        }
+    }
+
+    for (long index = first; index <= last; ++index)
+    {
+        if (tile_cache_find(cache, viewport.level, index) == NULL)
+        {
+            tile_cache_request(cache, viewport.level, index);
+            requested = 1;
+        }
+    }
+
+    for (long index = first; index <= last; ++index)
+    {
+        NCTile* tile = tile_cache_find(cache, viewport.level, index);
+
+        if (tile != NULL && tile->state == TILE_READY)
+        {
+            tile_draw(cache, tile, viewport, lines);
+
+            continue;
+        }
+
+        tile_cache_draw_fallback(cache, viewport, (double)index * width, (double)(index + 1) * width, lines);
+    }
+
+    if (requested)
+    {
+        pthread_cond_signal(&cache->wake);
+    }
+
+    pthread_mutex_unlock(&cache->mutex);
+}
+
+static void tile_cache_show(NCTileCache* cache, NCViewport initial, int lines, const char* frame_name)
+{
+    (void)frame_name;
+
+    NCViewport viewport = initial;
+
+    while(!WindowShouldClose())
+    {
+        NC_PROFILE_BEGIN(frame_name, 0, 0);
+
+        viewport_update(&viewport, initial);
+
+        BeginDrawing();
+        ClearBackground(RAYWHITE);
+
+        viewport_draw_axes(viewport);
+        tile_cache_draw(cache, viewport, lines);
 
         EndDrawing();
+
+        NC_PROFILE_END();
+    }
+}
+
+static void plot_produce(void* argument, double start, double end, double scale, NCSamples* destination)
+{
+    NCPlotSource* source = argument;
+
+    double first = start > source->start ? start : source->start;
+    double last = end < source->end ? end : source->end;
+
+    if (first >= last)
+    {
+        for (size_t i = 0; i < source->functions_amount; ++i)
+        {
+            destination[i] = (NCSamples){ 0, 0, NULL, NULL, NULL };
+        }
+
+        return;
+    }
+
+    double pixels = ceil((last - first) * scale);
+    NCSamplingConfig config = sampling_config(pixels > 1 ? (size_t)pixels : 1);
+
+    // sampling tolerances are in pixels, tiles sample in world units
+    config.tolerance /= scale;
+    config.jump /= scale;
+
+    sampling_adaptive_many(destination, source->functions_amount, source->functions, first, last, config);
+}
+
+static int scatter_compare(const void* first, const void* second)
+{
+    double a = ((const NCScatterPoint*)first)->x;
+    double b = ((const NCScatterPoint*)second)->x;
+
+    return (a > b) - (a < b);
+}
+
+static int scatter_compare_rows(const void* first, const void* second)
+{
+    long long a = *(const long long*)first;
+    long long b = *(const long long*)second;
+
+    return (a > b) - (a < b);
+}
+
+// position of the first sorted point with x not less than given x
+static size_t scatter_lower_bound(const NCScatterSource* source, double x)
+{
+    size_t low = 0;
+    size_t high = source->amount;
+
+    while (low < high)
+    {
+        size_t middle = low + (high - low) / 2;
+
+        if (source->sorted[middle].x < x)
+        {
+            low = middle + 1;
+        }
+        else
+        {
+            high = middle;
+        }
+    }
+
+    return low;
+}
+
+// one point per occupied cell of SCATTER_RADIUS pixels, placed at the cell center
+static void scatter_produce(void* argument, double start, double end, double scale, NCSamples* destination)
+{
+    NCScatterSource* source = argument;
+
+    if (source->sorted == NULL)
+    {
+        source->sorted = NC_MALLOC(sizeof(*source->sorted) * source->amount, "plot");
+        assert(source->sorted != NULL);
+
+        for (size_t i = 0; i < source->amount; ++i)
+        {
+            source->sorted[i] = (NCScatterPoint){ source->X[i], source->Y[i] };
+        }
+
+        qsort(source->sorted, source->amount, sizeof(*source->sorted), scatter_compare);
+    }
+
+    double cell = SCATTER_RADIUS / scale;
+    size_t low = scatter_lower_bound(source, start);
+    size_t high = scatter_lower_bound(source, end);
+
+    NCSamples samples = samples_allocate(PLOT_TILE_PIXELS);
+    long long* rows = NC_MALLOC(sizeof(*rows) * (high > low ? high - low : 1), "plot");
+    assert(rows != NULL);
+
+    size_t point = low;
+
+    while (point < high)
+    {
+        long long column = (long long)floor((source->sorted[point].x - start) / cell);
+        size_t rows_amount = 0;
+
+        for (; point < high && (long long)floor((source->sorted[point].x - start) / cell) == column; ++point)
+        {
+            rows[rows_amount++] = (long long)floor(source->sorted[point].y / cell);
+        }
+
+        qsort(rows, rows_amount, sizeof(*rows), scatter_compare_rows);
+
+        for (size_t i = 0; i < rows_amount; ++i)
+        {
+            if (i == 0 || rows[i] != rows[i - 1])
+            {
+                samples_push(&samples, start + ((double)column + 0.5) * cell, ((double)rows[i] + 0.5) * cell);
+            }
+        }
     }
+
+    NC_FREE(rows);
+
+    destination[0] = samples;
+}
+
+void init(void)
+{
+    InitWindow(WIDTH, HEIGHT, "@eesuck");
+    SetTargetFPS(NO_ANIMATION_FPS);
+}
+
+void plot(const double start, const double end, size_t functions_amount, function_type* functions)
+{
+    init();
+
+    NCPlotSource source = { functions_amount, functions, start, end };
+    NCViewport initial = { -WIDTH / 2.0, -HEIGHT / 2.0, 0 };
+    NCTileCache cache;
+
+    tile_cache_start(&cache, plot_produce, &source, functions_amount);
+    tile_cache_show(&cache, initial, 1, "plot_frame");
+    tile_cache_stop(&cache);
 }
 
 void circle(const double* X, const double* Y, const double* R, size_t circles_amount)
@@ -53,6 +552,8 @@ void circle(const double* X, const double* Y, const double* R, size_t circles_am
 
     while(!WindowShouldClose())
     {
+        NC_PROFILE_BEGIN("circle_frame", 0, 0);
+
         BeginDrawing();
         ClearBackground(RAYWHITE);
 
@@ -72,6 +573,8 @@ void circle(const double* X, const double* Y, const double* R, size_t circles_am
         }
 
         EndDrawing();
+
+        NC_PROFILE_END();
     }
 
 }
@@ -80,18 +583,15 @@ void scatter(const double *X, const double *Y, size_t amount)
 {
     init();
 
-    while(!WindowShouldClose())
-    {
-        BeginDrawing();
-        ClearBackground(RAYWHITE);
+    NCScatterSource source = { X, Y, amount, NULL };
+    NCViewport initial = { 0, 0, 0 };
+    NCTileCache cache;
 
-        for (size_t point = 0; point < amount; point++)
-        {
-            DrawCircle((int)X[point], HEIGHT - Y[point], 3, BASIC_COLOR);
-        }
+    tile_cache_start(&cache, scatter_produce, &source, 1);
+    tile_cache_show(&cache, initial, 0, "scatter_frame");
+    tile_cache_stop(&cache);
 
-        EndDrawing();
-    }
+    NC_FREE(source.sorted);
 }
 
 void bar(const double *Y, size_t amount)
@@ -102,6 +602,8 @@ void bar(const double *Y, size_t amount)
 
     while(!WindowShouldClose())
     {
+        NC_PROFILE_BEGIN("bar_frame", 0, 0);
+
         BeginDrawing();
         ClearBackground(RAYWHITE);
 
@@ -116,6 +618,8 @@ void bar(const double *Y, size_t amount)
         }
 
         EndDrawing();
+
+        NC_PROFILE_END();
     }
 }
 
@@ -2,21 +2,77 @@
 #define CPLOTLIB_H
 
 #include <assert.h>
+#include <pthread.h>
 
 #include "raylib.h"
 #include "numc.h"
+#include "ncsampling.h"
 
 #define WIDTH 800
 #define HEIGHT 600
 #define NO_ANIMATION_FPS 30
-#define ARRAY_SIZE 10000
+#define PLOT_LINE_THICKNESS 2.0f
+#define PLOT_TILE_PIXELS 256 // width of a cached tile on screen
+#define PLOT_TILE_CACHE 64 // amount of tiles kept across zoom levels
+#define PLOT_ZOOM_STEP 1.25 // scale change of one mouse wheel notch
+#define PLOT_ZOOM_LEVELS 40 // wheel notches allowed in each direction
+#define SCATTER_RADIUS 3
 #define COLORS_AMOUNT 12
 #define BASIC_COLOR CLITERAL(Color) { 72, 135, 184, 255 }
 
+/*
+ * plot and scatter windows pan with the left mouse button, zoom around the cursor with the wheel
+ * and reset with R. What is shown is cut into tiles of PLOT_TILE_PIXELS columns per zoom level,
+ * which a background thread samples or decimates while the window keeps drawing: a missing tile
+ * is stood in for by the closest zoom level already cached, so the previous view is shown scaled
+ * until the new one is ready. The least recently shown tiles are dropped first.
+ */
+
+typedef void (*tile_producer_type)(void* source, double start, double end, double scale, NCSamples* destination);
+
+typedef enum
+{
+    TILE_EMPTY,
+    TILE_PENDING,
+    TILE_WORKING,
+    TILE_READY
+} NCTileState; // NumC Tile state enumeration: free slot, requested, being produced or drawable
+
+typedef struct
+{
+    double left;
+    double bottom;
+    long level;
+} NCViewport; // NumC Viewport structure that contain: world coordinates of the bottom-left window corner and zoom level, PLOT_ZOOM_STEP^level pixels per unit
+
+typedef struct
+{
+    NCTileState state;
+    long level;
+    long index;
+    unsigned long long shown;
+    NCSamples* samples;
+} NCTile; // NumC Tile structure that contain: state, zoom level, position along x in tile widths, last frame it was wanted and samples of every series
+
+typedef struct
+{
+    tile_producer_type producer;
+    void* source;
+    size_t series_amount;
+
+    pthread_t thread;
+    pthread_mutex_t mutex;
+    pthread_cond_t wake;
+    int stopping;
+
+    unsigned long long frame;
+    NCTile tiles[PLOT_TILE_CACHE];
+} NCTileCache; // NumC Tile cache structure that contain: producer of series samples over a range, background thread and cached tiles
+
 void init(void); // initialize the raylib window
-void plot(double start, double end, size_t functions_amount, function_type* functions); // draws a plots of given number of functions
+void plot(double start, double end, size_t functions_amount, function_type* functions); // draws a plots of given number of functions on [start, end], adaptively sampled for the shown zoom
 void circle(const double* X, const double* Y, const double* R, size_t circles_amount); // draws a circles with centers in (x_i, y_i) and radius r_i
-void scatter(const double* X, const double* Y, size_t amount); // draws a scatter plot
+void scatter(const double* X, const double* Y, size_t amount); // draws a scatter plot, decimated to one point per SCATTER_RADIUS pixels for the shown zoom
 void bar(const double* Y, size_t amount); // draws a bar plot
 void histogram(const double* X, const double* Y, size_t amount); // draws a histogram
 
@@ -0,0 +1,118 @@
+#include "ncarena.h"
+
+#include <stdlib.h>
+
+#define ARENA_GRANULE (ARENA_ALIGNMENT / sizeof(double))
+
+static size_t arena_round(size_t amount)
+{
+    return (amount + ARENA_GRANULE - 1) / ARENA_GRANULE * ARENA_GRANULE;
+}
+
+static NCArenaBlock* arena_block_allocate(size_t capacity, NCArenaBlock* next)
+{
+    NCArenaBlock* block = NC_MALLOC(sizeof(*block), "arena");
+    assert(block != NULL);
+
+    block->next = next;
+    block->capacity = arena_round(capacity > 0 ? capacity : 1);
+    block->used = 0;
+    block->numbers = NC_ALIGNED_ALLOC(ARENA_ALIGNMENT, sizeof(*block->numbers) * block->capacity, "arena");
+
+    assert(block->numbers != NULL);
+
+    return block;
+}
+
+static void arena_blocks_delete(NCArenaBlock* block)
+{
+    while (block != NULL)
+    {
+        NCArenaBlock* next = block->next;
+
+        NC_FREE(block->numbers);
+        NC_FREE(block);
+
+        block = next;
+    }
+}
+
+NCArena* arena_allocate(size_t capacity)
+{
+    NCArena* arena = NC_MALLOC(sizeof(*arena), "arena");
+    assert(arena != NULL);
+
+    arena->blocks = arena_block_allocate(capacity, NULL);
+    arena->used = 0;
+    arena->peak = 0;
+
+    return arena;
+}
+
+double* arena_push(NCArena* arena, size_t amount)
+{
+    amount = arena_round(amount);
+
+    NCArenaBlock* block = arena->blocks;
+
+    if (block->used + amount > block->capacity)
+    {
+        size_t capacity = block->capacity * 2 > amount ? block->capacity * 2 : amount;
+
+        block = arena_block_allocate(capacity, block);
+        arena->blocks = block;
+    }
+
+    double* numbers = block->numbers + block->used;
+
+    block->used += amount;
+    arena->used += amount;
+
+    if (arena->used > arena->peak)
+    {
+        arena->peak = arena->used;
+    }
+
+    return numbers;
+}
+
+NCMatrix arena_matrix(NCArena* arena, size_t rows, size_t columns)
+{
+    NCMatrix matrix;
+
+    matrix.columns = columns;
+    matrix.rows = rows;
+    matrix.numbers = arena_push(arena, rows * columns);
+
+    return matrix;
+}
+
+void arena_reset(NCArena* arena)
+{
+    if (arena->blocks->next != NULL)
+    {
+        arena_blocks_delete(arena->blocks);
+        arena->blocks = arena_block_allocate(arena->peak, NULL);
+    }
+
+    arena->blocks->used = 0;
+    arena->used = 0;
+}
+
+size_t arena_capacity(const NCArena* arena)
+{
+    size_t capacity = 0;
+
+    for (const NCArenaBlock* block = arena->blocks; block != NULL; block = block->next)
+    {
+        capacity += block->capacity;
+    }
+
+    return capacity;
+}
+
+void arena_delete(NCArena* arena)
+{
+    arena_blocks_delete(arena->blocks);
+    NC_FREE(arena);
+}
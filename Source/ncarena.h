@@ -0,0 +1,38 @@
+#ifndef NCARENA_H
+#define NCARENA_H
+
+#include "ncmatrix.h"
+
+/*
+ * Bump allocator for per-call scratch buffers. Pushes are ARENA_ALIGNMENT aligned and stay valid
+ * until the next reset; when a push does not fit a new block is chained, and the next reset
+ * replaces the chain with a single block of the peak size, so a workload repeating the same
+ * pushes stops allocating after its first call. An arena is not thread-safe: push every
+ * per-thread slice before handing them to the pool.
+ */
+
+#define ARENA_ALIGNMENT 64
+
+typedef struct NCArenaBlock
+{
+    struct NCArenaBlock* next;
+    size_t capacity;
+    size_t used;
+    double* numbers;
+} NCArenaBlock; // NumC Arena block structure that contain: previous block, capacity and used amount of numbers, aligned data
+
+typedef struct
+{
+    NCArenaBlock* blocks;
+    size_t used;
+    size_t peak;
+} NCArena; // NumC Arena structure that contain: chain of blocks with the current one first, numbers pushed since the last reset and their peak
+
+NCArena* arena_allocate(size_t capacity); // allocates an arena with room for capacity numbers in one block
+double* arena_push(NCArena* arena, size_t amount); // returns uninitialized room for amount numbers, valid until the next reset
+NCMatrix arena_matrix(NCArena* arena, size_t rows, size_t columns); // returns an uninitialized Matrix living in the arena
+void arena_reset(NCArena* arena); // releases every push at once and coalesces chained blocks into one
+size_t arena_capacity(const NCArena* arena); // returns the amount of numbers the arena holds without allocating
+void arena_delete(NCArena* arena); // frees the arena and all of its blocks
+
+#endif // NCARENA_H
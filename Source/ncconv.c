@@ -0,0 +1,660 @@
+#include "ncconv.h"
+
+#include <stddef.h>
+
+#define CONV_GRANULE (ARENA_ALIGNMENT / sizeof(double))
+
+typedef struct
+{
+    NCConv2D layer;
+    NCMatrix destination;
+    NCMatrix input;
+    NCMatrix input_gradient;
+    NCMatrix output_gradient;
+    const double* weights_transposed;
+    double* scratch;
+    size_t scratch_stride;
+    size_t tasks_amount;
+} NCConvContext; // NumC Conv context structure that contain: layer, batch Matrices of the current call and per-task scratch slices
+
+typedef struct
+{
+    NCPool2D layer;
+    NCMatrix destination;
+    NCMatrix input;
+    NCMatrix input_gradient;
+    NCMatrix output_gradient;
+    size_t tasks_amount;
+} NCPoolContext; // NumC Pool context structure that contain: layer and batch Matrices of the current call
+
+static size_t conv_round(size_t amount)
+{
+    return (amount + CONV_GRANULE - 1) / CONV_GRANULE * CONV_GRANULE;
+}
+
+// rows [begin, end) of a batch handled by one of tasks_amount tasks
+static void conv_task_rows(size_t rows, size_t tasks_amount, size_t task, size_t* begin, size_t* end)
+{
+    *begin = task * rows / tasks_amount;
+    *end = (task + 1) * rows / tasks_amount;
+}
+
+static size_t conv_tasks_amount(size_t rows)
+{
+    size_t threads_amount = thread_pool_default()->threads_amount;
+
+    return rows < threads_amount ? (rows > 0 ? rows : 1) : threads_amount;
+}
+
+NCWindow window_square(size_t kernel, size_t stride, size_t padding)
+{
+    NCWindow window;
+
+    window.kernel_height = kernel;
+    window.kernel_width = kernel;
+    window.stride_height = stride;
+    window.stride_width = stride;
+    window.padding_height = padding;
+    window.padding_width = padding;
+    window.dilation_height = 1;
+    window.dilation_width = 1;
+
+    return window;
+}
+
+size_t window_output_length(size_t input, size_t kernel, size_t stride, size_t padding, size_t dilation)
+{
+    assert((kernel > 0 && stride > 0 && dilation > 0) && "Window kernel, stride and dilation must be positive!");
+
+    size_t extent = dilation * (kernel - 1) + 1;
+
+    assert((input + 2 * padding >= extent) && "Window does not fit into the padded input!");
+
+    return (input + 2 * padding - extent) / stride + 1;
+}
+
+static size_t conv2d_patch_length(NCConv2D layer)
+{
+    return layer.input_channels * layer.window.kernel_height * layer.window.kernel_width;
+}
+
+// a 1x1 unit-stride unpadded convolution reads the image as its own column Matrix
+static int conv2d_is_pointwise(NCConv2D layer)
+{
+    return layer.window.kernel_height == 1 && layer.window.kernel_width == 1 &&
+           layer.window.stride_height == 1 && layer.window.stride_width == 1 &&
+           layer.window.padding_height == 0 && layer.window.padding_width == 0;
+}
+
+// writes patch element r of output position p to columns[r * row_stride + p * column_stride], zeros outside the image
+static void conv2d_image_to_columns(NCConv2D layer, double* columns, size_t row_stride, size_t column_stride, const double* image)
+{
+    NCWindow window = layer.window;
+    size_t row = 0;
+
+    for (size_t channel = 0; channel < layer.input_channels; ++channel)
+    {
+        const double* plane = image + channel * layer.input_height * layer.input_width;
+
+        for (size_t ki = 0; ki < window.kernel_height; ++ki)
+        {
+            for (size_t kj = 0; kj < window.kernel_width; ++kj, ++row)
+            {
+                double* output = columns + row * row_stride;
+
+                for (size_t oy = 0; oy < layer.output_height; ++oy)
+                {
+                    ptrdiff_t iy = (ptrdiff_t)(oy * window.stride_height + ki * window.dilation_height) - (ptrdiff_t)window.padding_height;
+                    double* line = output + oy * layer.output_width * column_stride;
+
+                    if (iy < 0 || iy >= (ptrdiff_t)layer.input_height)
+                    {
+                        for (size_t ox = 0; ox < layer.output_width; ++ox)
+                        {
+                            line[ox * column_stride] = 0;
+                        }
+
+                        continue;
+                    }
+
+                    const double* source = plane + iy * layer.input_width;
+
+                    for (size_t ox = 0; ox < layer.output_width; ++ox)
+                    {
+                        ptrdiff_t ix = (ptrdiff_t)(ox * window.stride_width + kj * window.dilation_width) - (ptrdiff_t)window.padding_width;
+
+                        line[ox * column_stride] = ix >= 0 && ix < (ptrdiff_t)layer.input_width ? source[ix] : 0;
+                    }
+                }
+            }
+        }
+    }
+}
+
+// adds a ( patch x output area ) column Matrix back onto the image positions it was read from
+static void conv2d_columns_to_image(NCConv2D layer, double* image, const double* columns)
+{
+    NCWindow window = layer.window;
+    size_t output_area = layer.output_height * layer.output_width;
+    size_t row = 0;
+
+    for (size_t channel = 0; channel < layer.input_channels; ++channel)
+    {
+        double* plane = image + channel * layer.input_height * layer.input_width;
+
+        for (size_t ki = 0; ki < window.kernel_height; ++ki)
+        {
+            for (size_t kj = 0; kj < window.kernel_width; ++kj, ++row)
+            {
+                const double* input = columns + row * output_area;
+
+                for (size_t oy = 0; oy < layer.output_height; ++oy)
+                {
+                    ptrdiff_t iy = (ptrdiff_t)(oy * window.stride_height + ki * window.dilation_height) - (ptrdiff_t)window.padding_height;
+
+                    if (iy < 0 || iy >= (ptrdiff_t)layer.input_height)
+                    {
+                        continue;
+                    }
+
+                    double* destination = plane + iy * layer.input_width;
+                    const double* line = input + oy * layer.output_width;
+
+                    for (size_t ox = 0; ox < layer.output_width; ++ox)
+                    {
+                        ptrdiff_t ix = (ptrdiff_t)(ox * window.stride_width + kj * window.dilation_width) - (ptrdiff_t)window.padding_width;
+
+                        if (ix >= 0 && ix < (ptrdiff_t)layer.input_width)
+                        {
+                            destination[ix] += line[ox];
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+
+NCConv2D conv2d_allocate(size_t input_channels, size_t input_height, size_t input_width, size_t output_channels, NCWindow window)
+{
+    assert((input_channels > 0 && output_channels > 0) && "Convolution needs at least one input and one output channel!");
+
+    NCConv2D layer;
+
+    layer.input_channels = input_channels;
+    layer.input_height = input_height;
+    layer.input_width = input_width;
+    layer.output_channels = output_channels;
+    layer.output_height = window_output_length(input_height, window.kernel_height, window.stride_height, window.padding_height, window.dilation_height);
+    layer.output_width = window_output_length(input_width, window.kernel_width, window.stride_width, window.padding_width, window.dilation_width);
+    layer.window = window;
+
+    size_t patch_length = conv2d_patch_length(layer);
+
+    layer.weights = matrix_allocate(output_channels, patch_length);
+    layer.bias = matrix_allocate(1, output_channels);
+    layer.scratch = arena_allocate(patch_length * layer.output_height * layer.output_width);
+
+    matrix_random(layer.weights);
+    matrix_scale(layer.weights, sqrt(6.0 / (double)patch_length));
+    matrix_zero(layer.bias);
+
+    return layer;
+}
+
+size_t conv2d_input_length(NCConv2D layer)
+{
+    return layer.input_channels * layer.input_height * layer.input_width;
+}
+
+size_t conv2d_output_length(NCConv2D layer)
+{
+    return layer.output_channels * layer.output_height * layer.output_width;
+}
+
+static void conv2d_forward_task(void* argument, size_t task)
+{
+    NCConvContext* context = argument;
+    NCConv2D layer = context->layer;
+
+    size_t output_area = layer.output_height * layer.output_width;
+    size_t patch_length = conv2d_patch_length(layer);
+    double* columns = context->scratch + task * context->scratch_stride;
+    size_t begin, end;
+
+    conv_task_rows(context->input.rows, context->tasks_amount, task, &begin, &end);
+
+    for (size_t row = begin; row < end; ++row)
+    {
+        double* output = &MAT_AT(context->destination, row, 0);
+        const double* lowered = &MAT_AT(context->input, row, 0);
+
+        for (size_t channel = 0; channel < layer.output_channels; ++channel)
+        {
+            NCVector plane = { output_area, output + channel * output_area };
+
+            vector_fill(plane, layer.bias.numbers[channel]);
+        }
+
+        if (!conv2d_is_pointwise(layer))
+        {
+            conv2d_image_to_columns(layer, columns, output_area, 1, lowered);
+            lowered = columns;
+        }
+
+        matrix_dot_block(layer.output_channels, output_area, patch_length, 1.0,
+                         layer.weights.numbers, patch_length,
+                         lowered, output_area,
+                         output, output_area);
+    }
+}
+
+void conv2d_forward(NCConv2D layer, NCMatrix destination, NCMatrix input)
+{
+    assert((input.columns == conv2d_input_length(layer)) && "Input columns and Convolution input shape are incompatible");
+    assert((destination.rows == input.rows && destination.columns == conv2d_output_length(layer)) && "Destination dimensions must be correct!");
+
+    size_t output_area = layer.output_height * layer.output_width;
+    size_t patch_length = conv2d_patch_length(layer);
+
+    NC_PROFILE_BEGIN("conv2d_forward",
+                     2.0 * input.rows * layer.output_channels * output_area * patch_length,
+                     sizeof(double) * (input.rows * (input.columns + destination.columns) + layer.weights.rows * layer.weights.columns));
+
+    NCConvContext context;
+
+    context.layer = layer;
+    context.destination = destination;
+    context.input = input;
+    context.tasks_amount = conv_tasks_amount(input.rows);
+    context.scratch_stride = conv2d_is_pointwise(layer) ? 0 : conv_round(patch_length * output_area);
+
+    arena_reset(layer.scratch);
+    context.scratch = arena_push(layer.scratch, context.tasks_amount * context.scratch_stride);
+
+    thread_pool_run(thread_pool_default(), conv2d_forward_task, &context, context.tasks_amount);
+
+    NC_PROFILE_END();
+}
+
+static void conv2d_backward_task(void* argument, size_t task)
+{
+    NCConvContext* context = argument;
+    NCConv2D layer = context->layer;
+
+    size_t output_area = layer.output_height * layer.output_width;
+    size_t patch_length = conv2d_patch_length(layer);
+    size_t input_length = conv2d_input_length(layer);
+    size_t rows_length = conv_round(output_area * patch_length);
+    size_t weights_length = conv_round(layer.output_channels * patch_length);
+
+    // task slice: lowered rows, lowered deltas, partial weights gradient, partial bias gradient
+    double* lowered = context->scratch + task * context->scratch_stride;
+    double* deltas = lowered + rows_length;
+    double* weights_gradient = deltas + rows_length;
+    double* bias_gradient = weights_gradient + weights_length;
+    size_t begin, end;
+
+    conv_task_rows(context->input.rows, context->tasks_amount, task, &begin, &end);
+
+    vector_fill((NCVector){ layer.output_channels * patch_length, weights_gradient }, 0);
+    vector_fill((NCVector){ layer.output_channels, bias_gradient }, 0);
+
+    for (size_t row = begin; row < end; ++row)
+    {
+        const double* output_gradient = &MAT_AT(context->output_gradient, row, 0);
+
+        for (size_t channel = 0; channel < layer.output_channels; ++channel)
+        {
+            const double* plane = output_gradient + channel * output_area;
+
+            for (size_t p = 0; p < output_area; ++p)
+            {
+                bias_gradient[channel] += plane[p];
+            }
+        }
+
+        // ( output area x patch ) rows so the weights gradient is a plain product with the output gradient
+        conv2d_image_to_columns(layer, lowered, 1, patch_length, &MAT_AT(context->input, row, 0));
+
+        matrix_dot_block(layer.output_channels, patch_length, output_area, 1.0,
+                         output_gradient, output_area,
+                         lowered, patch_length,
+                         weights_gradient, patch_length);
+
+        if (context->input_gradient.numbers == NULL)
+        {
+            continue;
+        }
+
+        double* input_gradient = &MAT_AT(context->input_gradient, row, 0);
+
+        vector_fill((NCVector){ input_length, input_gradient }, 0);
+
+        if (conv2d_is_pointwise(layer))
+        {
+            matrix_dot_block(patch_length, output_area, layer.output_channels, 1.0,
+                             context->weights_transposed, layer.output_channels,
+                             output_gradient, output_area,
+                             input_gradient, output_area);
+
+            continue;
+        }
+
+        vector_fill((NCVector){ patch_length * output_area, deltas }, 0);
+
+        matrix_dot_block(patch_length, output_area, layer.output_channels, 1.0,
+                         context->weights_transposed, layer.output_channels,
+                         output_gradient, output_area,
+                         deltas, output_area);
+
+        conv2d_columns_to_image(layer, input_gradient, deltas);
+    }
+}
+
+void conv2d_backward(NCConv2D layer, NCMatrix input_gradient, NCMatrix weights_gradient, NCMatrix bias_gradient, NCMatrix output_gradient, NCMatrix input)
+{
+    assert((input.columns == conv2d_input_length(layer)) && "Input columns and Convolution input shape are incompatible");
+    assert((output_gradient.rows == input.rows && output_gradient.columns == conv2d_output_length(layer)) && "Output gradient dimensions must be correct!");
+    assert((weights_gradient.rows == layer.weights.rows && weights_gradient.columns == layer.weights.columns) && "Weights gradient dimensions must be correct!");
+    assert((bias_gradient.rows == layer.bias.rows && bias_gradient.columns == layer.bias.columns) && "Bias gradient dimensions must be correct!");
+    assert((input_gradient.numbers == NULL || (input_gradient.rows == input.rows && input_gradient.columns == input.columns)) && "Input gradient dimensions must be correct!");
+
+    size_t output_area = layer.output_height * layer.output_width;
+    size_t patch_length = conv2d_patch_length(layer);
+
+    NC_PROFILE_BEGIN("conv2d_backward",
+                     (input_gradient.numbers != NULL ? 4.0 : 2.0) * input.rows * layer.output_channels * output_area * patch_length,
+                     sizeof(double) * input.rows * (2 * input.columns + output_gradient.columns));
+
+    NCConvContext context;
+
+    context.layer = layer;
+    context.input = input;
+    context.input_gradient = input_gradient;
+    context.output_gradient = output_gradient;
+    context.tasks_amount = conv_tasks_amount(input.rows);
+    context.scratch_stride = 2 * conv_round(output_area * patch_length) + conv_round(layer.output_channels * patch_length) + conv_round(layer.output_channels);
+
+    arena_reset(layer.scratch);
+
+    NCMatrix weights_transposed = arena_matrix(layer.scratch, patch_length, layer.output_channels);
+
+    for (size_t i = 0; i < layer.weights.rows; ++i)
+    {
+        for (size_t j = 0; j < layer.weights.columns; ++j)
+        {
+            MAT_AT(weights_transposed, j, i) = MAT_AT(layer.weights, i, j);
+        }
+    }
+
+    context.weights_transposed = weights_transposed.numbers;
+    context.scratch = arena_push(layer.scratch, context.tasks_amount * context.scratch_stride);
+
+    thread_pool_run(thread_pool_default(), conv2d_backward_task, &context, context.tasks_amount);
+
+    matrix_zero(weights_gradient);
+    matrix_zero(bias_gradient);
+
+    for (size_t task = 0; task < context.tasks_amount; ++task)
+    {
+        double* partial = context.scratch + task * context.scratch_stride + 2 * conv_round(output_area * patch_length);
+        NCMatrix partial_weights = { weights_gradient.columns, weights_gradient.rows, partial };
+        NCMatrix partial_bias = { bias_gradient.columns, bias_gradient.rows, partial + conv_round(layer.output_channels * patch_length) };
+
+        matrix_axpy(weights_gradient, 1.0, partial_weights);
+        matrix_axpy(bias_gradient, 1.0, partial_bias);
+    }
+
+    NC_PROFILE_END();
+}
+
+void conv2d_delete(NCConv2D layer)
+{
+    matrix_delete(layer.weights);
+    matrix_delete(layer.bias);
+    arena_delete(layer.scratch);
+}
+
+NCPool2D pool2d_create(size_t channels, size_t input_height, size_t input_width, NCWindow window, NCPoolMode mode)
+{
+    NCPool2D layer;
+
+    layer.channels = channels;
+    layer.input_height = input_height;
+    layer.input_width = input_width;
+    layer.output_height = window_output_length(input_height, window.kernel_height, window.stride_height, window.padding_height, window.dilation_height);
+    layer.output_width = window_output_length(input_width, window.kernel_width, window.stride_width, window.padding_width, window.dilation_width);
+    layer.window = window;
+    layer.mode = mode;
+
+    return layer;
+}
+
+size_t pool2d_input_length(NCPool2D layer)
+{
+    return layer.channels * layer.input_height * layer.input_width;
+}
+
+size_t pool2d_output_length(NCPool2D layer)
+{
+    return layer.channels * layer.output_height * layer.output_width;
+}
+
+// position of the first largest in-image element of a window, or -1 when the window covers only padding
+static ptrdiff_t pool2d_window_argmax(NCPool2D layer, const double* plane, size_t oy, size_t ox)
+{
+    NCWindow window = layer.window;
+    ptrdiff_t position = -1;
+    double largest = 0;
+
+    for (size_t ki = 0; ki < window.kernel_height; ++ki)
+    {
+        ptrdiff_t iy = (ptrdiff_t)(oy * window.stride_height + ki * window.dilation_height) - (ptrdiff_t)window.padding_height;
+
+        if (iy < 0 || iy >= (ptrdiff_t)layer.input_height)
+        {
+            continue;
+        }
+
+        for (size_t kj = 0; kj < window.kernel_width; ++kj)
+        {
+            ptrdiff_t ix = (ptrdiff_t)(ox * window.stride_width + kj * window.dilation_width) - (ptrdiff_t)window.padding_width;
+            ptrdiff_t index = iy * (ptrdiff_t)layer.input_width + ix;
+
+            if (ix >= 0 && ix < (ptrdiff_t)layer.input_width && (position < 0 || plane[index] > largest))
+            {
+                position = index;
+                largest = plane[index];
+            }
+        }
+    }
+
+    return position;
+}
+
+// sum and amount of in-image elements of a window, adding gradient to each of them when plane_gradient is not NULL
+static double pool2d_window_sum(NCPool2D layer, const double* plane, double* plane_gradient, double gradient, size_t oy, size_t ox, size_t* amount)
+{
+    NCWindow window = layer.window;
+    double sum = 0;
+
+    *amount = 0;
+
+    for (size_t ki = 0; ki < window.kernel_height; ++ki)
+    {
+        ptrdiff_t iy = (ptrdiff_t)(oy * window.stride_height + ki * window.dilation_height) - (ptrdiff_t)window.padding_height;
+
+        if (iy < 0 || iy >= (ptrdiff_t)layer.input_height)
+        {
+            continue;
+        }
+
+        for (size_t kj = 0; kj < window.kernel_width; ++kj)
+        {
+            ptrdiff_t ix = (ptrdiff_t)(ox * window.stride_width + kj * window.dilation_width) - (ptrdiff_t)window.padding_width;
+
+            if (ix < 0 || ix >= (ptrdiff_t)layer.input_width)
+            {
+                continue;
+            }
+
+            ptrdiff_t index = iy * (ptrdiff_t)layer.input_width + ix;
+
+            if (plane_gradient != NULL)
+            {
+                plane_gradient[index] += gradient;
+            }
+            else
+            {
+                sum += plane[index];
+            }
+
+            *amount += 1;
+        }
+    }
+
+    return sum;
+}
+
+static void pool2d_forward_task(void* argument, size_t task)
+{
+    NCPoolContext* context = argument;
+    NCPool2D layer = context->layer;
+
+    size_t input_area = layer.input_height * layer.input_width;
+    size_t output_area = layer.output_height * layer.output_width;
+    size_t begin, end;
+
+    conv_task_rows(context->input.rows, context->tasks_amount, task, &begin, &end);
+
+    for (size_t row = begin; row < end; ++row)
+    {
+        for (size_t channel = 0; channel < layer.channels; ++channel)
+        {
+            const double* plane = &MAT_AT(context->input, row, channel * input_area);
+            double* output = &MAT_AT(context->destination, row, channel * output_area);
+
+            for (size_t oy = 0; oy < layer.output_height; ++oy)
+            {
+                for (size_t ox = 0; ox < layer.output_width; ++ox)
+                {
+                    double value = 0;
+
+                    if (layer.mode == POOL_MAX)
+                    {
+                        ptrdiff_t position = pool2d_window_argmax(layer, plane, oy, ox);
+
+                        value = position >= 0 ? plane[position] : 0;
+                    }
+                    else
+                    {
+                        size_t amount;
+                        double sum = pool2d_window_sum(layer, plane, NULL, 0, oy, ox, &amount);
+
+                        value = amount > 0 ? sum / (double)amount : 0;
+                    }
+
+                    output[oy * layer.output_width + ox] = value;
+                }
+            }
+        }
+    }
+}
+
+void pool2d_forward(NCPool2D layer, NCMatrix destination, NCMatrix input)
+{
+    assert((input.columns == pool2d_input_length(layer)) && "Input columns and Pool input shape are incompatible");
+    assert((destination.rows == input.rows && destination.columns == pool2d_output_length(layer)) && "Destination dimensions must be correct!");
+
+    NC_PROFILE_BEGIN("pool2d_forward",
+                     (double)destination.rows * destination.columns * layer.window.kernel_height * layer.window.kernel_width,
+                     sizeof(double) * input.rows * (input.columns + destination.columns));
+
+    NCPoolContext context;
+
+    context.layer = layer;
+    context.destination = destination;
+    context.input = input;
+    context.tasks_amount = conv_tasks_amount(input.rows);
+
+    thread_pool_run(thread_pool_default(), pool2d_forward_task, &context, context.tasks_amount);
+
+    NC_PROFILE_END();
+}
+
+static void pool2d_backward_task(void* argument, size_t task)
+{
+    NCPoolContext* context = argument;
+    NCPool2D layer = context->layer;
+
+    size_t input_area = layer.input_height * layer.input_width;
+    size_t output_area = layer.output_height * layer.output_width;
+    size_t begin, end;
+
+    conv_task_rows(context->input.rows, context->tasks_amount, task, &begin, &end);
+
+    for (size_t row = begin; row < end; ++row)
+    {
+        vector_fill((NCVector){ context->input_gradient.columns, &MAT_AT(context->input_gradient, row, 0) }, 0);
+
+        for (size_t channel = 0; channel < layer.channels; ++channel)
+        {
+            const double* plane = &MAT_AT(context->input, row, channel * input_area);
+            double* plane_gradient = &MAT_AT(context->input_gradient, row, channel * input_area);
+            const double* output_gradient = &MAT_AT(context->output_gradient, row, channel * output_area);
+
+            for (size_t oy = 0; oy < layer.output_height; ++oy)
+            {
+                for (size_t ox = 0; ox < layer.output_width; ++ox)
+                {
+                    double gradient = output_gradient[oy * layer.output_width + ox];
+
+                    if (layer.mode == POOL_MAX)
+                    {
+                        ptrdiff_t position = pool2d_window_argmax(layer, plane, oy, ox);
+
+                        if (position >= 0)
+                        {
+                            plane_gradient[position] += gradient;
+                        }
+
+                        continue;
+                    }
+
+                    size_t amount;
+
+                    pool2d_window_sum(layer, plane, NULL, 0, oy, ox, &amount);
+
+                    if (amount > 0)
+                    {
+                        pool2d_window_sum(layer, plane, plane_gradient, gradient / (double)amount, oy, ox, &amount);
+                    }
+                }
+            }
+        }
+    }
+}
+
+void pool2d_backward(NCPool2D layer, NCMatrix input_gradient, NCMatrix output_gradient, NCMatrix input)
+{
+    assert((input.columns == pool2d_input_length(layer)) && "Input columns and Pool input shape are incompatible");
+    assert((input_gradient.rows == input.rows && input_gradient.columns == input.columns) && "Input gradient dimensions must be correct!");
+    assert((output_gradient.rows == input.rows && output_gradient.columns == pool2d_output_length(layer)) && "Output gradient dimensions must be correct!");
+
+    NC_PROFILE_BEGIN("pool2d_backward",
+                     (double)output_gradient.rows * output_gradient.columns * layer.window.kernel_height * layer.window.kernel_width,
+                     sizeof(double) * input.rows * (2 * input.columns + output_gradient.columns));
+
+    NCPoolContext context;
+
+    context.layer = layer;
+    context.input = input;
+    context.input_gradient = input_gradient;
+    context.output_gradient = output_gradient;
+    context.tasks_amount = conv_tasks_amount(input.rows);
+
+    thread_pool_run(thread_pool_default(), pool2d_backward_task, &context, context.tasks_amount);
+
+    NC_PROFILE_END();
+}
@@ -0,0 +1,79 @@
+#ifndef NCCONV_H
+#define NCCONV_H
+
+#include "ncmatrix.h"
+#include "ncarena.h"
+#include "ncthread.h"
+
+/*
+ * 2D convolution and pooling over batches of images stored one per Matrix row in
+ * channel-major order, row b holding image b as channels x height x width.
+ *
+ * Convolution lowers every image to a ( input channels * kernel area ) x ( output area ) column
+ * Matrix in the layer scratch arena and multiplies it by the weights through matrix_dot_block,
+ * which yields the output image already in channel-major order. Images are split across the
+ * default thread pool, each task with its own column buffer; the arena keeps those buffers
+ * between calls. Outputs are rows of the same layout, so a flattened conv2d or pool2d output
+ * can be passed as activations[0] of perceptron_forward_batch.
+ */
+
+typedef struct
+{
+    size_t kernel_height;
+    size_t kernel_width;
+    size_t stride_height;
+    size_t stride_width;
+    size_t padding_height;
+    size_t padding_width;
+    size_t dilation_height;
+    size_t dilation_width;
+} NCWindow; // NumC Window structure that contain: kernel size, stride, zero padding and dilation of a sliding window along height and width
+
+typedef struct
+{
+    size_t input_channels;
+    size_t input_height;
+    size_t input_width;
+    size_t output_channels;
+    size_t output_height;
+    size_t output_width;
+    NCWindow window;
+    NCMatrix weights;
+    NCMatrix bias;
+    NCArena* scratch;
+} NCConv2D; // NumC Conv2D structure that contain: input and output image shapes, window, ( output channels x input channels * kernel area ) weights, ( 1 x output channels ) bias and scratch arena
+
+typedef enum
+{
+    POOL_MAX,
+    POOL_AVERAGE
+} NCPoolMode; // NumC Pool mode enumeration: maximum or average of each window, padding never takes part
+
+typedef struct
+{
+    size_t channels;
+    size_t input_height;
+    size_t input_width;
+    size_t output_height;
+    size_t output_width;
+    NCWindow window;
+    NCPoolMode mode;
+} NCPool2D; // NumC Pool2D structure that contain: amount of channels, input and output image sizes, window and mode
+
+NCWindow window_square(size_t kernel, size_t stride, size_t padding); // returns a window with equal height and width parameters and no dilation
+size_t window_output_length(size_t input, size_t kernel, size_t stride, size_t padding, size_t dilation); // returns how many window positions fit along one dimension
+
+NCConv2D conv2d_allocate(size_t input_channels, size_t input_height, size_t input_width, size_t output_channels, NCWindow window); // allocates a convolution layer with random weights scaled by fan-in and zero bias
+size_t conv2d_input_length(NCConv2D layer); // returns the amount of columns of an input batch Matrix
+size_t conv2d_output_length(NCConv2D layer); // returns the amount of columns of an output batch Matrix
+void conv2d_forward(NCConv2D layer, NCMatrix destination, NCMatrix input); // convolves every input row into the same destination row
+void conv2d_backward(NCConv2D layer, NCMatrix input_gradient, NCMatrix weights_gradient, NCMatrix bias_gradient, NCMatrix output_gradient, NCMatrix input); // puts gradients of the batch loss into weights and bias gradients, and into input gradient unless its numbers are NULL
+void conv2d_delete(NCConv2D layer); // deletes weights, bias and scratch of the layer
+
+NCPool2D pool2d_create(size_t channels, size_t input_height, size_t input_width, NCWindow window, NCPoolMode mode); // returns a pooling layer of given input shape
+size_t pool2d_input_length(NCPool2D layer); // returns the amount of columns of an input batch Matrix
+size_t pool2d_output_length(NCPool2D layer); // returns the amount of columns of an output batch Matrix
+void pool2d_forward(NCPool2D layer, NCMatrix destination, NCMatrix input); // pools every input row into the same destination row
+void pool2d_backward(NCPool2D layer, NCMatrix input_gradient, NCMatrix output_gradient, NCMatrix input); // puts the gradient of the batch loss with respect to input into input gradient, maximum windows route it to their first largest element
+
+#endif // NCCONV_H
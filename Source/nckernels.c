@@ -0,0 +1,110 @@
+#include "nckernels.h"
+
+#if defined(__clang__)
+#define KERNEL_UNROLL _Pragma("unroll")
+#elif defined(__GNUC__)
+#define KERNEL_UNROLL _Pragma("GCC unroll 32")
+#else
+#define KERNEL_UNROLL
+#endif
+
+#define KERNEL_FOR_SIZES(MACRO) MACRO(1) MACRO(2) MACRO(4) MACRO(8) MACRO(16) MACRO(32)
+#define KERNEL_FOR_PAIRS(MACRO, K) MACRO(K, 1) MACRO(K, 2) MACRO(K, 4) MACRO(K, 8) MACRO(K, 16) MACRO(K, 32)
+
+#define DOT_KERNEL(K, M)                                                        \
+static void kernel_dot_##K##x##M(NCMatrix destination, NCMatrix first, NCMatrix second) \
+{                                                                               \
+    const double* weights = second.numbers;                                     \
+                                                                                \
+    for (size_t row = 0; row < destination.rows; ++row)                         \
+    {                                                                           \
+        const double* input = first.numbers + row * (K);                        \
+        double* output = destination.numbers + row * (M);                       \
+        double accumulator[M] = { 0 };                                          \
+                                                                                \
+        KERNEL_UNROLL                                                           \
+        for (size_t k = 0; k < (K); ++k)                                        \
+        {                                                                       \
+            KERNEL_UNROLL                                                       \
+            for (size_t j = 0; j < (M); ++j)                                    \
+            {                                                                   \
+                accumulator[j] += input[k] * weights[k * (M) + j];              \
+            }                                                                   \
+        }                                                                       \
+                                                                                \
+        KERNEL_UNROLL                                                           \
+        for (size_t j = 0; j < (M); ++j)                                        \
+        {                                                                       \
+            output[j] = accumulator[j];                                         \
+        }                                                                       \
+    }                                                                           \
+}
+
+#define APPLY_KERNEL(M)                                                         \
+static void kernel_apply_##M(NCMatrix matrix, function_type function)          \
+{                                                                               \
+    for (size_t row = 0; row < matrix.rows; ++row)                              \
+    {                                                                           \
+        KERNEL_UNROLL                                                           \
+        for (size_t j = 0; j < (M); ++j)                                        \
+        {                                                                       \
+            MAT_AT(matrix, row, j) = function(MAT_AT(matrix, row, j));          \
+        }                                                                       \
+    }                                                                           \
+}
+
+#define DOT_KERNEL_ROW(K) KERNEL_FOR_PAIRS(DOT_KERNEL, K)
+
+KERNEL_FOR_SIZES(DOT_KERNEL_ROW)
+KERNEL_FOR_SIZES(APPLY_KERNEL)
+
+#define DOT_TABLE_ENTRY(K, M) kernel_dot_##K##x##M,
+#define DOT_TABLE_ROW(K) { KERNEL_FOR_PAIRS(DOT_TABLE_ENTRY, K) },
+#define APPLY_TABLE_ENTRY(M) kernel_apply_##M,
+
+static const dot_kernel_type dot_kernels[KERNEL_SIZES_AMOUNT][KERNEL_SIZES_AMOUNT] = { KERNEL_FOR_SIZES(DOT_TABLE_ROW) };
+static const apply_kernel_type apply_kernels[KERNEL_SIZES_AMOUNT] = { KERNEL_FOR_SIZES(APPLY_TABLE_ENTRY) };
+
+static int kernel_size_index(size_t size)
+{
+    switch (size)
+    {
+        case 1: return 0;
+        case 2: return 1;
+        case 4: return 2;
+        case 8: return 3;
+        case 16: return 4;
+        case 32: return 5;
+        default: return -1;
+    }
+}
+
+dot_kernel_type kernel_dot_select(size_t inner, size_t columns)
+{
+    int inner_index = kernel_size_index(inner);
+    int columns_index = kernel_size_index(columns);
+
+    if (inner_index < 0 || columns_index < 0)
+    {
+        return matrix_dot;
+    }
+
+    return dot_kernels[inner_index][columns_index];
+}
+
+apply_kernel_type kernel_apply_select(size_t columns)
+{
+    int index = kernel_size_index(columns);
+
+    return index < 0 ? apply_to_matrix : apply_kernels[index];
+}
+
+NCKernel kernel_bind(size_t inputs, size_t outputs)
+{
+    NCKernel kernel;
+
+    kernel.dot = kernel_dot_select(inputs, outputs);
+    kernel.apply = kernel_apply_select(outputs);
+
+    return kernel;
+}
@@ -0,0 +1,28 @@
+#ifndef NCKERNELS_H
+#define NCKERNELS_H
+
+#include "ncmatrix.h"
+
+/*
+ * Fully unrolled kernels for small fixed layer shapes, generated by macros for every
+ * ( inner x columns ) pair with sizes in KERNEL_SIZES. Kernels loop over destination rows,
+ * so they serve single samples and batches alike, and skip all dimension checks:
+ * shapes are checked once when a kernel is bound.
+ */
+
+#define KERNEL_SIZES_AMOUNT 6 // sizes 1, 2, 4, 8, 16, 32
+
+typedef void (*dot_kernel_type)(NCMatrix destination, NCMatrix first, NCMatrix second);
+typedef void (*apply_kernel_type)(NCMatrix matrix, function_type function);
+
+typedef struct
+{
+    dot_kernel_type dot;
+    apply_kernel_type apply;
+} NCKernel; // NumC Kernel structure that contain: dot and apply kernels bound to one layer shape
+
+dot_kernel_type kernel_dot_select(size_t inner, size_t columns); // returns a specialized ( rows x inner ) x ( inner x columns ) dot kernel, or matrix_dot for other shapes
+apply_kernel_type kernel_apply_select(size_t columns); // returns a specialized apply kernel for rows of given length, or apply_to_matrix
+NCKernel kernel_bind(size_t inputs, size_t outputs); // returns kernels of a layer mapping inputs to outputs neurons
+
+#endif // NCKERNELS_H
@@ -0,0 +1,467 @@
+#include "nclinalg.h"
+
+#include <math.h>
+
+static size_t block_width(size_t position, size_t length)
+{
+    return position + LINALG_BLOCK_SIZE < length ? LINALG_BLOCK_SIZE : length - position;
+}
+
+static void row_swap(NCMatrix matrix, size_t first, size_t second)
+{
+    if (first == second)
+    {
+        return;
+    }
+
+    for (size_t j = 0; j < matrix.columns; ++j)
+    {
+        double temporary = MAT_AT(matrix, first, j);
+        MAT_AT(matrix, first, j) = MAT_AT(matrix, second, j);
+        MAT_AT(matrix, second, j) = temporary;
+    }
+}
+
+static void row_axpy(NCMatrix matrix, size_t destination, size_t source, double scalar)
+{
+    for (size_t j = 0; j < matrix.columns; ++j)
+    {
+        MAT_AT(matrix, destination, j) += scalar * MAT_AT(matrix, source, j);
+    }
+}
+
+static void back_substitute(NCMatrix solution, NCMatrix upper)
+{
+    for (size_t i = upper.columns; i-- > 0;)
+    {
+        for (size_t j = i + 1; j < upper.columns; ++j)
+        {
+            row_axpy(solution, i, j, -MAT_AT(upper, i, j));
+        }
+
+        assert((MAT_AT(upper, i, i) != 0) && "Matrix is singular!");
+
+        double scale = 1.0 / MAT_AT(upper, i, i);
+
+        for (size_t j = 0; j < solution.columns; ++j)
+        {
+            MAT_AT(solution, i, j) *= scale;
+        }
+    }
+}
+
+void matrix_lu(NCMatrix matrix, size_t* pivots)
+{
+    assert((matrix.rows == matrix.columns) && "LU factorization requires a square Matrix!");
+
+    size_t n = matrix.rows;
+
+    NC_PROFILE_BEGIN("matrix_lu", 2.0 / 3.0 * n * n * n, sizeof(double) * n * n);
+
+    for (size_t k = 0; k < n; k += LINALG_BLOCK_SIZE)
+    {
+        size_t width = block_width(k, n);
+        size_t end = k + width;
+
+        // panel: unblocked LU of columns k..end with full row swaps
+        for (size_t j = k; j < end; ++j)
+        {
+            size_t pivot = j;
+
+            for (size_t i = j + 1; i < n; ++i)
+            {
+                if (fabs(MAT_AT(matrix, i, j)) > fabs(MAT_AT(matrix, pivot, j))) pivot = i;
+            }
+
+            pivots[j] = pivot;
+            row_swap(matrix, j, pivot);
+
+            assert((MAT_AT(matrix, j, j) != 0) && "Matrix is singular!");
+
+            double scale = 1.0 / MAT_AT(matrix, j, j);
+
+            for (size_t i = j + 1; i < n; ++i)
+            {
+                MAT_AT(matrix, i, j) *= scale;
+
+                for (size_t c = j + 1; c < end; ++c)
+                {
+                    MAT_AT(matrix, i, c) -= MAT_AT(matrix, i, j) * MAT_AT(matrix, j, c);
+                }
+            }
+        }
+
+        if (end == n)
+        {
+            break;
+        }
+
+        // block row of U: solve L11 U12 = A12
+        for (size_t j = k + 1; j < end; ++j)
+        {
+            for (size_t r = k; r < j; ++r)
+            {
+                double factor = MAT_AT(matrix, j, r);
+
+                for (size_t c = end; c < n; ++c)
+                {
+                    MAT_AT(matrix, j, c) -= factor * MAT_AT(matrix, r, c);
+                }
+            }
+        }
+
+        // trailing update: A22 -= L21 U12
+        matrix_dot_block(n - end, n - end, width, -1.0,
+                         &MAT_AT(matrix, end, k), n,
+                         &MAT_AT(matrix, k, end), n,
+                         &MAT_AT(matrix, end, end), n);
+    }
+
+    NC_PROFILE_END();
+}
+
+void matrix_lu_solve(NCMatrix solution, NCMatrix lu, const size_t* pivots, NCMatrix right)
+{
+    assert((lu.rows == lu.columns) && "LU factors must be square!");
+    assert((right.rows == lu.rows) && "Right-hand side rows and Matrix rows are incompatible");
+
+    matrix_copy(solution, right);
+
+    for (size_t i = 0; i < lu.rows; ++i)
+    {
+        row_swap(solution, i, pivots[i]);
+    }
+
+    for (size_t i = 1; i < lu.rows; ++i)
+    {
+        for (size_t j = 0; j < i; ++j)
+        {
+            row_axpy(solution, i, j, -MAT_AT(lu, i, j));
+        }
+    }
+
+    back_substitute(solution, lu);
+}
+
+void matrix_cholesky(NCMatrix matrix)
+{
+    assert((matrix.rows == matrix.columns) && "Cholesky factorization requires a square Matrix!");
+
+    size_t n = matrix.rows;
+    double* panel = NC_MALLOC(sizeof(*panel) * LINALG_BLOCK_SIZE * n, "linalg");
+
+    assert(panel != NULL);
+
+    NC_PROFILE_BEGIN("matrix_cholesky", 1.0 / 3.0 * n * n * n, sizeof(double) * n * n);
+
+    for (size_t k = 0; k < n; k += LINALG_BLOCK_SIZE)
+    {
+        size_t width = block_width(k, n);
+        size_t end = k + width;
+
+        // diagonal block and panel below it: L21 = A21 L11^-T, column by column
+        for (size_t j = k; j < end; ++j)
+        {
+            double diagonal = MAT_AT(matrix, j, j);
+
+            for (size_t r = k; r < j; ++r)
+            {
+                diagonal -= MAT_AT(matrix, j, r) * MAT_AT(matrix, j, r);
+            }
+
+            assert((diagonal > 0) && "Matrix is not positive definite!");
+
+            MAT_AT(matrix, j, j) = sqrt(diagonal);
+
+            double scale = 1.0 / MAT_AT(matrix, j, j);
+
+            for (size_t i = j + 1; i < n; ++i)
+            {
+                double value = MAT_AT(matrix, i, j);
+
+                for (size_t r = k; r < j; ++r)
+                {
+                    value -= MAT_AT(matrix, i, r) * MAT_AT(matrix, j, r);
+                }
+
+                MAT_AT(matrix, i, j) = value * scale;
+            }
+        }
+
+        size_t remaining = n - end;
+
+        if (remaining == 0)
+        {
+            break;
+        }
+
+        // trailing update of the lower block triangle: A22 -= L21 L21^T
+        for (size_t r = 0; r < width; ++r)
+        {
+            for (size_t i = 0; i < remaining; ++i)
+            {
+                panel[r * remaining + i] = MAT_AT(matrix, end + i, k + r);
+            }
+        }
+
+        for (size_t block = 0; block < remaining; block += LINALG_BLOCK_SIZE)
+        {
+            matrix_dot_block(remaining - block, block_width(block, remaining), width, -1.0,
+                             &MAT_AT(matrix, end + block, k), n,
+                             panel + block, remaining,
+                             &MAT_AT(matrix, end + block, end + block), n);
+        }
+    }
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        for (size_t j = i + 1; j < n; ++j)
+        {
+            MAT_AT(matrix, i, j) = 0.0;
+        }
+    }
+
+    NC_PROFILE_END();
+
+    NC_FREE(panel);
+}
+
+void matrix_cholesky_solve(NCMatrix solution, NCMatrix cholesky, NCMatrix right)
+{
+    assert((cholesky.rows == cholesky.columns) && "Cholesky factor must be square!");
+    assert((right.rows == cholesky.rows) && "Right-hand side rows and Matrix rows are incompatible");
+
+    matrix_copy(solution, right);
+
+    for (size_t i = 0; i < cholesky.rows; ++i)
+    {
+        for (size_t j = 0; j < i; ++j)
+        {
+            row_axpy(solution, i, j, -MAT_AT(cholesky, i, j));
+        }
+
+        double scale = 1.0 / MAT_AT(cholesky, i, i);
+
+        for (size_t j = 0; j < solution.columns; ++j)
+        {
+            MAT_AT(solution, i, j) *= scale;
+        }
+    }
+
+    for (size_t i = cholesky.rows; i-- > 0;)
+    {
+        for (size_t j = i + 1; j < cholesky.rows; ++j)
+        {
+            row_axpy(solution, i, j, -MAT_AT(cholesky, j, i));
+        }
+
+        double scale = 1.0 / MAT_AT(cholesky, i, i);
+
+        for (size_t j = 0; j < solution.columns; ++j)
+        {
+            MAT_AT(solution, i, j) *= scale;
+        }
+    }
+}
+
+// applies Q^T = I - Y T^T Y^T of `width` reflectors stored below the diagonal of a ( rows x width ) block to a ( rows x columns ) block
+static void householder_apply_block(const double* reflectors, size_t reflectors_stride, const double* tau,
+                                    size_t rows, size_t width, double* block, size_t block_stride, size_t columns)
+{
+    double* y = NC_MALLOC(sizeof(*y) * rows * width, "linalg");
+    double* y_transposed = NC_MALLOC(sizeof(*y_transposed) * width * rows, "linalg");
+    double* t_transposed = NC_CALLOC(width * width, sizeof(*t_transposed), "linalg");
+    double* product = NC_CALLOC(width * columns, sizeof(*product), "linalg");
+    double* scaled = NC_CALLOC(width * columns, sizeof(*scaled), "linalg");
+
+    assert(y != NULL && y_transposed != NULL && t_transposed != NULL && product != NULL && scaled != NULL);
+
+    for (size_t i = 0; i < rows; ++i)
+    {
+        for (size_t j = 0; j < width; ++j)
+        {
+            double value = i == j ? 1.0 : (i > j ? reflectors[i * reflectors_stride + j] : 0.0);
+
+            y[i * width + j] = value;
+            y_transposed[j * rows + i] = value;
+        }
+    }
+
+    // T is upper triangular: T[0:j, j] = -tau_j T[0:j, 0:j] Y[:, 0:j]^T v_j, kept transposed
+    double projection[width];
+
+    for (size_t j = 0; j < width; ++j)
+    {
+        for (size_t i = 0; i < j; ++i)
+        {
+            projection[i] = 0;
+
+            for (size_t r = j; r < rows; ++r)
+            {
+                projection[i] += y_transposed[i * rows + r] * y_transposed[j * rows + r];
+            }
+        }
+
+        for (size_t i = 0; i < j; ++i)
+        {
+            double value = 0;
+
+            for (size_t l = i; l < j; ++l)
+            {
+                value += t_transposed[l * width + i] * projection[l];
+            }
+
+            t_transposed[j * width + i] = -tau[j] * value;
+        }
+
+        t_transposed[j * width + j] = tau[j];
+    }
+
+    matrix_dot_block(width, columns, rows, 1.0, y_transposed, rows, block, block_stride, product, columns);
+    matrix_dot_block(width, columns, width, 1.0, t_transposed, width, product, columns, scaled, columns);
+    matrix_dot_block(rows, columns, width, -1.0, y, width, scaled, columns, block, block_stride);
+
+    NC_FREE(y);
+    NC_FREE(y_transposed);
+    NC_FREE(t_transposed);
+    NC_FREE(product);
+    NC_FREE(scaled);
+}
+
+void matrix_qr(NCMatrix matrix, double* tau)
+{
+    assert((matrix.rows >= matrix.columns) && "QR factorization requires rows >= columns!");
+
+    size_t m = matrix.rows;
+    size_t n = matrix.columns;
+
+    NC_PROFILE_BEGIN("matrix_qr", 2.0 * m * n * n - 2.0 / 3.0 * n * n * n, sizeof(double) * m * n);
+
+    for (size_t k = 0; k < n; k += LINALG_BLOCK_SIZE)
+    {
+        size_t width = block_width(k, n);
+        size_t end = k + width;
+
+        // panel: unblocked Householder reflectors H = I - tau v v^T with v_0 = 1
+        for (size_t j = k; j < end; ++j)
+        {
+            double alpha = MAT_AT(matrix, j, j);
+            double sigma = 0;
+
+            for (size_t i = j + 1; i < m; ++i)
+            {
+                sigma += MAT_AT(matrix, i, j) * MAT_AT(matrix, i, j);
+            }
+
+            if (sigma == 0)
+            {
+                tau[j] = 0;
+                continue;
+            }
+
+            double norm = sqrt(alpha * alpha + sigma);
+            double beta = alpha <= 0 ? norm : -norm;
+            double scale = 1.0 / (alpha - beta);
+
+            tau[j] = (beta - alpha) / beta;
+            MAT_AT(matrix, j, j) = beta;
+
+            for (size_t i = j + 1; i < m; ++i)
+            {
+                MAT_AT(matrix, i, j) *= scale;
+            }
+
+            for (size_t c = j + 1; c < end; ++c)
+            {
+                double w = MAT_AT(matrix, j, c);
+
+                for (size_t i = j + 1; i < m; ++i)
+                {
+                    w += MAT_AT(matrix, i, j) * MAT_AT(matrix, i, c);
+                }
+
+                w *= tau[j];
+                MAT_AT(matrix, j, c) -= w;
+
+                for (size_t i = j + 1; i < m; ++i)
+                {
+                    MAT_AT(matrix, i, c) -= w * MAT_AT(matrix, i, j);
+                }
+            }
+        }
+
+        if (end < n)
+        {
+            householder_apply_block(&MAT_AT(matrix, k, k), n, tau + k, m - k, width,
+                                    &MAT_AT(matrix, k, end), n, n - end);
+        }
+    }
+
+    NC_PROFILE_END();
+}
+
+void matrix_qr_apply_transpose(NCMatrix qr, const double* tau, NCMatrix matrix)
+{
+    assert((qr.rows == matrix.rows) && "QR factors rows and Matrix rows are incompatible");
+
+    for (size_t k = 0; k < qr.columns; k += LINALG_BLOCK_SIZE)
+    {
+        householder_apply_block(&MAT_AT(qr, k, k), qr.columns, tau + k, qr.rows - k, block_width(k, qr.columns),
+                                &MAT_AT(matrix, k, 0), matrix.columns, matrix.columns);
+    }
+}
+
+void matrix_solve(NCMatrix solution, NCMatrix matrix, NCMatrix right)
+{
+    NCMatrix lu = matrix_allocate(matrix.rows, matrix.columns);
+    size_t* pivots = NC_MALLOC(sizeof(*pivots) * matrix.rows, "linalg");
+
+    assert(pivots != NULL);
+
+    matrix_copy(lu, matrix);
+    matrix_lu(lu, pivots);
+    matrix_lu_solve(solution, lu, pivots, right);
+
+    NC_FREE(pivots);
+    matrix_delete(lu);
+}
+
+void matrix_lstsq(NCMatrix solution, NCMatrix matrix, NCMatrix right)
+{
+    assert((matrix.rows == right.rows) && "Right-hand side rows and Matrix rows are incompatible");
+    assert((solution.rows == matrix.columns && solution.columns == right.columns) && "Solution dimensions must be correct!");
+
+    NCMatrix qr = matrix_allocate(matrix.rows, matrix.columns);
+    NCMatrix projected = matrix_allocate(right.rows, right.columns);
+    double* tau = NC_MALLOC(sizeof(*tau) * matrix.columns, "linalg");
+
+    assert(tau != NULL);
+
+    matrix_copy(qr, matrix);
+    matrix_copy(projected, right);
+
+    matrix_qr(qr, tau);
+    matrix_qr_apply_transpose(qr, tau, projected);
+
+    memcpy(solution.numbers, projected.numbers, sizeof(double) * solution.rows * solution.columns);
+    back_substitute(solution, qr);
+
+    NC_FREE(tau);
+    matrix_delete(projected);
+    matrix_delete(qr);
+}
+
+void matrix_inverse(NCMatrix destination, NCMatrix matrix)
+{
+    NCMatrix identity = matrix_allocate(matrix.rows, matrix.columns);
+
+    matrix_zero(identity);
+
+    for (size_t i = 0; i < matrix.rows; ++i)
+    {
+        MAT_AT(identity, i, i) = 1.0;
+    }
+
+    matrix_solve(destination, matrix, identity);
+    matrix_delete(identity);
+}
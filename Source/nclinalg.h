@@ -0,0 +1,24 @@
+#ifndef NCLINALG_H
+#define NCLINALG_H
+
+#include "ncmatrix.h"
+
+/*
+ * Blocked right-looking factorizations: each step factors a LINALG_BLOCK_SIZE wide panel
+ * with level-2 loops and pushes the trailing update through matrix_dot_block,
+ * so large factorizations spend their time in the level-3 kernel.
+ */
+
+#define LINALG_BLOCK_SIZE 64
+
+void matrix_lu(NCMatrix matrix, size_t* pivots); // in-place LU with partial pivoting of a square Matrix, P A = L U with unit L below the diagonal, row i was swapped with row pivots[i]
+void matrix_lu_solve(NCMatrix solution, NCMatrix lu, const size_t* pivots, NCMatrix right); // solves A X = B from matrix_lu factors
+void matrix_cholesky(NCMatrix matrix); // in-place Cholesky of a symmetric positive definite Matrix, A = L L^T with L in the lower triangle and zeros above
+void matrix_cholesky_solve(NCMatrix solution, NCMatrix cholesky, NCMatrix right); // solves A X = B from matrix_cholesky factor
+void matrix_qr(NCMatrix matrix, double* tau); // in-place Householder QR of a Matrix with rows >= columns, R in the upper triangle, reflectors below the diagonal with scales in tau
+void matrix_qr_apply_transpose(NCMatrix qr, const double* tau, NCMatrix matrix); // replaces matrix by Q^T matrix using matrix_qr reflectors
+void matrix_solve(NCMatrix solution, NCMatrix matrix, NCMatrix right); // solves A X = B for a square A through LU, A is left unchanged
+void matrix_lstsq(NCMatrix solution, NCMatrix matrix, NCMatrix right); // least-squares solution of A X = B for rows >= columns through QR, A is left unchanged
+void matrix_inverse(NCMatrix destination, NCMatrix matrix); // puts an inverse of a square Matrix into destination through LU
+
+#endif // NCLINALG_H
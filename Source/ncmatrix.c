@@ -1,5 +1,8 @@
 #include "ncmatrix.h"
 
+#define MATRIX_BLOCK_INNER 128
+#define MATRIX_BLOCK_COLUMNS 512
+
 static long long get_seed()
 {
     static long long SEED = 0;
@@ -13,7 +16,7 @@ NCMatrix matrix_allocate(size_t rows, size_t columns)
 
     matrix.columns = columns;
     matrix.rows = rows;
-    matrix.numbers = malloc(sizeof(*matrix.numbers) * columns * rows);
+    matrix.numbers = NC_MALLOC(sizeof(*matrix.numbers) * columns * rows, "matrix");
 
     assert(matrix.numbers != NULL);
 
@@ -61,13 +64,7 @@ void matrix_copy(NCMatrix destination, NCMatrix source)
     assert(destination.rows == source.rows && "Destination and Source row lengths must be the same!");
     assert(destination.columns == source.columns && "Destination and Source column lengths must be the same!");
 
-    for (size_t i = 0; i < destination.rows; ++i)
-    {
-        for (size_t j = 0; j < destination.columns; ++j)
-        {
-            MAT_AT(destination, i, j) = MAT_AT(source, i, j);
-        }
-    }
+    vector_copy(matrix_as_vector(destination), matrix_as_vector(source));
 }
 
 double matrix_at(NCMatrix matrix, size_t row, size_t column)
@@ -83,15 +80,46 @@ void matrix_dot(NCMatrix destination, NCMatrix first, NCMatrix second)
     assert((first.columns == second.rows) && "First columns must be the same as second rows");
     assert((first.rows == destination.rows && second.columns == destination.columns) && "Destination dimensions must be correct!");
 
-    for (size_t i = 0; i < destination.rows; ++i)
+    NC_PROFILE_BEGIN("matrix_dot",
+                     2.0 * destination.rows * destination.columns * first.columns,
+                     sizeof(double) * (first.rows * first.columns + second.rows * second.columns + destination.rows * destination.columns));
+
+    matrix_zero(destination);
+    matrix_dot_block(destination.rows, destination.columns, first.columns, 1.0,
+                     first.numbers, first.columns,
+                     second.numbers, second.columns,
+                     destination.numbers, destination.columns);
+
+    NC_PROFILE_END();
+}
+
+void matrix_dot_block(size_t rows, size_t columns, size_t inner, double scalar,
+                      const double* first, size_t first_stride,
+                      const double* second, size_t second_stride,
+                      double* destination, size_t destination_stride)
+{
+    for (size_t inner_block = 0; inner_block < inner; inner_block += MATRIX_BLOCK_INNER)
     {
-        for (size_t j = 0; j < destination.columns; ++j)
+        size_t inner_end = inner_block + MATRIX_BLOCK_INNER < inner ? inner_block + MATRIX_BLOCK_INNER : inner;
+
+        for (size_t column_block = 0; column_block < columns; column_block += MATRIX_BLOCK_COLUMNS)
         {
-            MAT_AT(destination, i, j) = 0;
+            size_t column_end = column_block + MATRIX_BLOCK_COLUMNS < columns ? column_block + MATRIX_BLOCK_COLUMNS : columns;
 
-            for (size_t k = 0; k < first.columns; ++k)
+            for (size_t i = 0; i < rows; ++i)
             {
-                MAT_AT(destination, i, j) += MAT_AT(first, i, k) * MAT_AT(second, k, j);
+                double* restrict output = destination + i * destination_stride;
+
+                for (size_t k = inner_block; k < inner_end; ++k)
+                {
+                    double factor = scalar * first[i * first_stride + k];
+                    const double* restrict row = second + k * second_stride;
+
+                    for (size_t j = column_block; j < column_end; ++j)
+                    {
+                        output[j] += factor * row[j];
+                    }
+                }
             }
         }
     }
@@ -102,13 +130,11 @@ void matrix_sum(NCMatrix destination, NCMatrix first, NCMatrix second)
     assert((first.rows == second.rows && second.rows ==  destination.rows) && "Matrix rows must be the same!");
     assert((first.columns == second.columns && second.columns ==  destination.columns) && "Matrix columns must be the same!");
 
-    for (size_t i = 0; i < destination.rows; ++i)
-    {
-        for (size_t j = 0; j < destination.columns; ++j)
-        {
-            MAT_AT(destination, i, j) = MAT_AT(first, i, j) + MAT_AT(second, i, j);
-        }
-    }
+    NC_PROFILE_BEGIN("matrix_sum", destination.rows * destination.columns, 3 * sizeof(double) * destination.rows * destination.columns);
+
+    vector_sum(matrix_as_vector(destination), matrix_as_vector(first), matrix_as_vector(second));
+
+    NC_PROFILE_END();
 }
 
 
@@ -144,13 +170,7 @@ double matrix_sum_of_values(NCMatrix matrix)
 
 void matrix_scale(NCMatrix matrix, double scalar)
 {
-    for (size_t i = 0; i < matrix.rows; ++i)
-    {
-        for (size_t j = 0; j < matrix.columns; ++j)
-        {
-            MAT_AT(matrix, i, j) *= scalar;
-        }
-    }
+    vector_scale(matrix_as_vector(matrix), scalar);
 }
 
 void matrix_print(NCMatrix matrix)
@@ -183,17 +203,13 @@ void matrix_random(NCMatrix matrix)
 
 void matrix_zero(NCMatrix matrix)
 {
-    for (size_t i = 0; i < matrix.rows; ++i)
-    {
-        for (size_t j = 0; j < matrix.columns; ++j)
-        {
-            MAT_AT(matrix, i, j) = 0.0;
-        }
-    }
+    vector_fill(matrix_as_vector(matrix), 0.0);
 }
 
 void apply_to_matrix(NCMatrix matrix, function_type function)
 {
+    NC_PROFILE_BEGIN("apply_to_matrix", matrix.rows * matrix.columns, 2 * sizeof(double) * matrix.rows * matrix.columns);
+
     for (size_t i = 0; i < matrix.rows; ++i)
     {
         for (size_t j = 0; j < matrix.columns; ++j)
@@ -201,6 +217,8 @@ void apply_to_matrix(NCMatrix matrix, function_type function)
             MAT_AT(matrix, i, j) = function(MAT_AT(matrix, i, j));
         }
     }
+
+    NC_PROFILE_END();
 }
 
 void matrix_transpose_inplace(NCMatrix* matrix)
@@ -219,8 +237,87 @@ NCMatrix matrix_transpose(NCMatrix matrix)
     return result;
 }
 
+NCVector matrix_as_vector(NCMatrix matrix)
+{
+    NCVector vector;
+
+    vector.length = matrix.rows * matrix.columns;
+    vector.numbers = matrix.numbers;
+
+    return vector;
+}
+
+void matrix_axpy(NCMatrix destination, double scalar, NCMatrix source)
+{
+    assert((destination.rows == source.rows && destination.columns == source.columns) && "Matrix dimensions must be the same!");
+
+    vector_axpy(matrix_as_vector(destination), scalar, matrix_as_vector(source));
+}
+
+void matrix_axpby(NCMatrix destination, double first_scalar, NCMatrix source, double second_scalar)
+{
+    assert((destination.rows == source.rows && destination.columns == source.columns) && "Matrix dimensions must be the same!");
+
+    vector_axpby(matrix_as_vector(destination), first_scalar, matrix_as_vector(source), second_scalar);
+}
+
+void matrix_multiply(NCMatrix destination, NCMatrix first, NCMatrix second)
+{
+    assert((first.rows == second.rows && second.rows == destination.rows) && "Matrix rows must be the same!");
+    assert((first.columns == second.columns && second.columns == destination.columns) && "Matrix columns must be the same!");
+
+    vector_multiply(matrix_as_vector(destination), matrix_as_vector(first), matrix_as_vector(second));
+}
+
+void matrix_divide(NCMatrix destination, NCMatrix first, NCMatrix second)
+{
+    assert((first.rows == second.rows && second.rows == destination.rows) && "Matrix rows must be the same!");
+    assert((first.columns == second.columns && second.columns == destination.columns) && "Matrix columns must be the same!");
+
+    vector_divide(matrix_as_vector(destination), matrix_as_vector(first), matrix_as_vector(second));
+}
+
+void matrix_fma(NCMatrix destination, NCMatrix first, NCMatrix second)
+{
+    assert((first.rows == second.rows && second.rows == destination.rows) && "Matrix rows must be the same!");
+    assert((first.columns == second.columns && second.columns == destination.columns) && "Matrix columns must be the same!");
+
+    vector_fma(matrix_as_vector(destination), matrix_as_vector(first), matrix_as_vector(second));
+}
+
+double matrix_min(NCMatrix matrix)
+{
+    return vector_min(matrix_as_vector(matrix));
+}
+
+double matrix_max(NCMatrix matrix)
+{
+    return vector_max(matrix_as_vector(matrix));
+}
+
+size_t matrix_argmax(NCMatrix matrix)
+{
+    return vector_argmax(matrix_as_vector(matrix));
+}
+
+void matrix_clamp(NCMatrix matrix, double minimum, double maximum)
+{
+    vector_clamp(matrix_as_vector(matrix), minimum, maximum);
+}
+
+void matrix_fill(NCMatrix matrix, double value)
+{
+    vector_fill(matrix_as_vector(matrix), value);
+}
+
+void matrix_swap(NCMatrix first, NCMatrix second)
+{
+    assert((first.rows == second.rows && first.columns == second.columns) && "Matrix dimensions must be the same!");
+
+    vector_swap(matrix_as_vector(first), matrix_as_vector(second));
+}
 
 void matrix_delete(NCMatrix matrix)
 {
-    free(matrix.numbers);
+    NC_FREE(matrix.numbers);
 }
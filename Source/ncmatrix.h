@@ -21,6 +21,7 @@ typedef double (*function_type)(double x);
 #include <string.h>
 
 #include "ncvector.h"
+#include "ncprofile.h"
 
 typedef struct
 {
@@ -37,6 +38,7 @@ void matrix_initialize_v(NCMatrix matrix, const NCVector* initializer, size_t in
 void matrix_copy(NCMatrix destination, NCMatrix source); // copies data from source Matrix into destination Matrix
 double matrix_at(NCMatrix matrix, size_t row, size_t column); // returns an element at given position
 void matrix_dot(NCMatrix destination, NCMatrix first, NCMatrix second); // produces a matrix dot product between first and second and puts into destination
+void matrix_dot_block(size_t rows, size_t columns, size_t inner, double scalar, const double* first, size_t first_stride, const double* second, size_t second_stride, double* destination, size_t destination_stride); // destination += scalar * first x second on row-major blocks with given row strides, the level-3 core of matrix_dot
 void matrix_sum(NCMatrix destination, NCMatrix first, NCMatrix second); // produces a matrix sum between first and second and puts into destination
 void matrix_difference(NCMatrix destination, NCMatrix first, NCMatrix second);
 double matrix_sum_of_values(NCMatrix matrix); // returns a sum of all values in matrix;
@@ -47,6 +49,18 @@ void matrix_zero(NCMatrix matrix); // feels a matrix with 0.0
 void apply_to_matrix(NCMatrix matrix, function_type function); // apply a given function to each element of a Matrix in-place
 NCMatrix matrix_transpose(NCMatrix matrix); // ...
 void matrix_transpose_inplace(NCMatrix* matrix); // transpose the given by reference Matrix in-place
+NCVector matrix_as_vector(NCMatrix matrix); // returns a Vector view over all numbers of a Matrix
+void matrix_axpy(NCMatrix destination, double scalar, NCMatrix source); // destination += scalar * source
+void matrix_axpby(NCMatrix destination, double first_scalar, NCMatrix source, double second_scalar); // destination = first_scalar * source + second_scalar * destination
+void matrix_multiply(NCMatrix destination, NCMatrix first, NCMatrix second); // elementwise product of first and second into destination
+void matrix_divide(NCMatrix destination, NCMatrix first, NCMatrix second); // elementwise quotient of first and second into destination
+void matrix_fma(NCMatrix destination, NCMatrix first, NCMatrix second); // destination += first * second elementwise
+double matrix_min(NCMatrix matrix); // returns the smallest element
+double matrix_max(NCMatrix matrix); // returns the largest element
+size_t matrix_argmax(NCMatrix matrix); // returns the flattened position ( row * columns + column ) of the first largest element
+void matrix_clamp(NCMatrix matrix, double minimum, double maximum); // clamps every element into [minimum, maximum] in-place
+void matrix_fill(NCMatrix matrix, double value); // fills a matrix with given value
+void matrix_swap(NCMatrix first, NCMatrix second); // exchanges data of two matrices
 void matrix_delete(NCMatrix matrix); // deletes the matrix
 
 #endif // NCMATRIX_H
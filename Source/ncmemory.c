@@ -0,0 +1,408 @@
+#include "ncmemory.h"
+
+#include <assert.h>
+#include <malloc.h>
+#include <stdlib.h>
+#include <string.h>
+
+static void* memory_default_allocate(void* user, size_t size, size_t alignment)
+{
+    (void)user;
+
+    if (alignment == 0)
+    {
+        return malloc(size);
+    }
+
+    return aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment);
+}
+
+static void* memory_default_reallocate(void* user, void* pointer, size_t size)
+{
+    (void)user;
+
+    return realloc(pointer, size);
+}
+
+static void memory_default_release(void* user, void* pointer)
+{
+    (void)user;
+
+    free(pointer);
+}
+
+static const NCAllocator memory_default_allocator = { memory_default_allocate, memory_default_reallocate, memory_default_release, NULL };
+
+static NCAllocator memory_current_allocator = { memory_default_allocate, memory_default_reallocate, memory_default_release, NULL };
+
+void memory_set_allocator(const NCAllocator* allocator)
+{
+    if (allocator == NULL)
+    {
+        memory_current_allocator = memory_default_allocator;
+
+        return;
+    }
+
+    assert((allocator->allocate != NULL && allocator->reallocate != NULL && allocator->release != NULL) && "Allocator must provide every hook!");
+
+    memory_current_allocator = *allocator;
+}
+
+NCAllocator memory_allocator(void)
+{
+    return memory_current_allocator;
+}
+
+#ifdef NUMC_MEMORY
+
+#include <pthread.h>
+#include <stdio.h>
+
+#define MEMORY_HEADER_SIZE MEMORY_MAX_ALIGNMENT // keeps user pointers as aligned as the blocks behind them
+#define MEMORY_MAX_SITES 256
+#define MEMORY_MAX_SUBSYSTEMS 32
+
+typedef struct
+{
+    size_t size;
+    size_t site;
+} NCMemoryHeader; // NumC Memory header structure that contain: requested size and call site index of a tracked block
+
+typedef struct
+{
+    const char* file;
+    int line;
+    size_t subsystem;
+    NCMemoryStats stats;
+} NCMemorySite; // NumC Memory site structure that contain: source position, subsystem index and counters of one call site
+
+typedef struct
+{
+    const char* name;
+    NCMemoryStats stats;
+} NCMemorySubsystem; // NumC Memory subsystem structure that contain: subsystem name and counters of all its call sites
+
+static pthread_mutex_t memory_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_once_t memory_exit_once = PTHREAD_ONCE_INIT;
+
+static NCMemoryStats memory_total;
+static NCMemorySite memory_sites[MEMORY_MAX_SITES];
+static size_t memory_sites_amount = 0;
+static NCMemorySubsystem memory_subsystems[MEMORY_MAX_SUBSYSTEMS];
+static size_t memory_subsystems_amount = 0;
+
+static void memory_exit_report(void)
+{
+    pthread_mutex_lock(&memory_mutex);
+    size_t live_blocks = memory_total.live_blocks;
+    pthread_mutex_unlock(&memory_mutex);
+
+    if (live_blocks > 0)
+    {
+        memory_report_leaks();
+    }
+}
+
+static void memory_register_exit(void)
+{
+    atexit(memory_exit_report);
+}
+
+// returns the index of a call site, registering it and its subsystem on first use, the memory mutex must be held
+static size_t memory_site(const char* subsystem, const char* file, int line)
+{
+    for (size_t i = 0; i < memory_sites_amount; ++i)
+    {
+        if (memory_sites[i].line == line && strcmp(memory_sites[i].file, file) == 0)
+        {
+            return i;
+        }
+    }
+
+    assert((memory_sites_amount < MEMORY_MAX_SITES) && "Too many distinct allocation sites!");
+
+    size_t index = 0;
+
+    while (index < memory_subsystems_amount && strcmp(memory_subsystems[index].name, subsystem) != 0)
+    {
+        ++index;
+    }
+
+    if (index == memory_subsystems_amount)
+    {
+        assert((memory_subsystems_amount < MEMORY_MAX_SUBSYSTEMS) && "Too many distinct allocation subsystems!");
+
+        memory_subsystems[index].name = subsystem;
+        memory_subsystems_amount += 1;
+    }
+
+    NCMemorySite* site = &memory_sites[memory_sites_amount];
+
+    site->file = file;
+    site->line = line;
+    site->subsystem = index;
+
+    return memory_sites_amount++;
+}
+
+static void memory_stats_add(NCMemoryStats* stats, size_t size)
+{
+    stats->live_bytes += size;
+    stats->live_blocks += 1;
+    stats->allocations += 1;
+
+    if (stats->live_bytes > stats->peak_bytes)
+    {
+        stats->peak_bytes = stats->live_bytes;
+    }
+}
+
+static void memory_stats_remove(NCMemoryStats* stats, size_t size)
+{
+    stats->live_bytes -= size;
+    stats->live_blocks -= 1;
+    stats->releases += 1;
+}
+
+// records a block at a site, the memory mutex must be held
+static void memory_track(NCMemoryHeader* header, size_t size, size_t site)
+{
+    header->size = size;
+    header->site = site;
+
+    memory_stats_add(&memory_total, size);
+    memory_stats_add(&memory_sites[site].stats, size);
+    memory_stats_add(&memory_subsystems[memory_sites[site].subsystem].stats, size);
+}
+
+// forgets a block, the memory mutex must be held
+static void memory_untrack(const NCMemoryHeader* header)
+{
+    memory_stats_remove(&memory_total, header->size);
+    memory_stats_remove(&memory_sites[header->site].stats, header->size);
+    memory_stats_remove(&memory_subsystems[memory_sites[header->site].subsystem].stats, header->size);
+}
+
+void* memory_allocate(size_t size, size_t alignment, const char* subsystem, const char* file, int line)
+{
+    assert((alignment <= MEMORY_MAX_ALIGNMENT && (alignment & (alignment - 1)) == 0) && "Alignment must be a power of two up to MEMORY_MAX_ALIGNMENT!");
+
+    pthread_once(&memory_exit_once, memory_register_exit);
+
+    NCMemoryHeader* header = memory_current_allocator.allocate(memory_current_allocator.user, MEMORY_HEADER_SIZE + size, alignment);
+
+    if (header == NULL)
+    {
+        return NULL;
+    }
+
+    pthread_mutex_lock(&memory_mutex);
+    memory_track(header, size, memory_site(subsystem, file, line));
+    pthread_mutex_unlock(&memory_mutex);
+
+    return (char*)header + MEMORY_HEADER_SIZE;
+}
+
+void* memory_reallocate(void* pointer, size_t size, const char* subsystem, const char* file, int line)
+{
+    if (pointer == NULL)
+    {
+        return memory_allocate(size, 0, subsystem, file, line);
+    }
+
+    NCMemoryHeader* header = (NCMemoryHeader*)((char*)pointer - MEMORY_HEADER_SIZE);
+    NCMemoryHeader previous = *header;
+
+    NCMemoryHeader* resized = memory_current_allocator.reallocate(memory_current_allocator.user, header, MEMORY_HEADER_SIZE + size);
+
+    if (resized == NULL)
+    {
+        return NULL;
+    }
+
+    pthread_mutex_lock(&memory_mutex);
+    memory_untrack(&previous);
+    memory_track(resized, size, memory_site(subsystem, file, line));
+    pthread_mutex_unlock(&memory_mutex);
+
+    return (char*)resized + MEMORY_HEADER_SIZE;
+}
+
+void memory_release(void* pointer)
+{
+    if (pointer == NULL)
+    {
+        return;
+    }
+
+    NCMemoryHeader* header = (NCMemoryHeader*)((char*)pointer - MEMORY_HEADER_SIZE);
+
+    pthread_mutex_lock(&memory_mutex);
+    memory_untrack(header);
+    pthread_mutex_unlock(&memory_mutex);
+
+    memory_current_allocator.release(memory_current_allocator.user, header);
+}
+
+NCMemoryStats memory_stats(void)
+{
+    pthread_mutex_lock(&memory_mutex);
+    NCMemoryStats stats = memory_total;
+    pthread_mutex_unlock(&memory_mutex);
+
+    return stats;
+}
+
+NCMemoryStats memory_subsystem_stats(const char* subsystem)
+{
+    NCMemoryStats stats = { 0 };
+
+    pthread_mutex_lock(&memory_mutex);
+
+    for (size_t i = 0; i < memory_subsystems_amount; ++i)
+    {
+        if (strcmp(memory_subsystems[i].name, subsystem) == 0)
+        {
+            stats = memory_subsystems[i].stats;
+        }
+    }
+
+    pthread_mutex_unlock(&memory_mutex);
+
+    return stats;
+}
+
+static const char* memory_file_name(const char* file)
+{
+    const char* slash = strrchr(file, '/');
+
+    return slash != NULL ? slash + 1 : file;
+}
+
+static void memory_print_stats(const char* name, NCMemoryStats stats)
+{
+    printf("%-40s %12.1f %12.1f %10zu %12llu %12llu\n",
+           name,
+           (double)stats.live_bytes / 1024.0,
+           (double)stats.peak_bytes / 1024.0,
+           stats.live_blocks,
+           stats.allocations,
+           stats.releases);
+}
+
+void memory_print_summary(void)
+{
+    char name[64];
+
+    pthread_mutex_lock(&memory_mutex);
+
+    printf("NumC memory (%zu subsystems, %zu call sites)\n", memory_subsystems_amount, memory_sites_amount);
+    printf("%-40s %12s %12s %10s %12s %12s\n", "subsystem", "live KiB", "peak KiB", "blocks", "allocations", "releases");
+
+    memory_print_stats("total", memory_total);
+
+    for (size_t i = 0; i < memory_subsystems_amount; ++i)
+    {
+        memory_print_stats(memory_subsystems[i].name, memory_subsystems[i].stats);
+    }
+
+    printf("\n%-40s %12s %12s %10s %12s %12s\n", "call site", "live KiB", "peak KiB", "blocks", "allocations", "releases");
+
+    for (size_t i = 0; i < memory_sites_amount; ++i)
+    {
+        snprintf(name, sizeof(name), "%s:%d", memory_file_name(memory_sites[i].file), memory_sites[i].line);
+        memory_print_stats(name, memory_sites[i].stats);
+    }
+
+    pthread_mutex_unlock(&memory_mutex);
+}
+
+size_t memory_report_leaks(void)
+{
+    pthread_mutex_lock(&memory_mutex);
+
+    size_t live_blocks = memory_total.live_blocks;
+
+    printf("NumC memory: %zu blocks, %zu bytes live\n", live_blocks, memory_total.live_bytes);
+
+    for (size_t i = 0; i < memory_sites_amount; ++i)
+    {
+        NCMemorySite site = memory_sites[i];
+
+        if (site.stats.live_blocks > 0)
+        {
+            printf("    %s:%d ( %s ): %zu blocks, %zu bytes\n", memory_file_name(site.file), site.line, memory_subsystems[site.subsystem].name, site.stats.live_blocks, site.stats.live_bytes);
+        }
+    }
+
+    pthread_mutex_unlock(&memory_mutex);
+
+    return live_blocks;
+}
+
+void memory_reset_peak(void)
+{
+    pthread_mutex_lock(&memory_mutex);
+
+    memory_total.peak_bytes = memory_total.live_bytes;
+
+    for (size_t i = 0; i < memory_sites_amount; ++i)
+    {
+        memory_sites[i].stats.peak_bytes = memory_sites[i].stats.live_bytes;
+    }
+
+    for (size_t i = 0; i < memory_subsystems_amount; ++i)
+    {
+        memory_subsystems[i].stats.peak_bytes = memory_subsystems[i].stats.live_bytes;
+    }
+
+    pthread_mutex_unlock(&memory_mutex);
+}
+
+#else
+
+void* memory_allocate(size_t size, size_t alignment, const char* subsystem, const char* file, int line)
+{
+    (void)subsystem;
+    (void)file;
+    (void)line;
+
+    assert((alignment <= MEMORY_MAX_ALIGNMENT && (alignment & (alignment - 1)) == 0) && "Alignment must be a power of two up to MEMORY_MAX_ALIGNMENT!");
+
+    return memory_current_allocator.allocate(memory_current_allocator.user, size, alignment);
+}
+
+void* memory_reallocate(void* pointer, size_t size, const char* subsystem, const char* file, int line)
+{
+    if (pointer == NULL)
+    {
+        return memory_allocate(size, 0, subsystem, file, line);
+    }
+
+    return memory_current_allocator.reallocate(memory_current_allocator.user, pointer, size);
+}
+
+void memory_release(void* pointer)
+{
+    if (pointer != NULL)
+    {
+        memory_current_allocator.release(memory_current_allocator.user, pointer);
+    }
+}
+
+#endif // NUMC_MEMORY
+
+void* memory_zero_allocate(size_t amount, size_t size, const char* subsystem, const char* file, int line)
+{
+    assert((size == 0 || amount <= (size_t)-1 / size) && "Allocation size overflows!");
+
+    void* pointer = memory_allocate(amount * size, 0, subsystem, file, line);
+
+    if (pointer != NULL)
+    {
+        memset(pointer, 0, amount * size);
+    }
+
+    return pointer;
+}
@@ -0,0 +1,71 @@
+#ifndef NCMEMORY_H
+#define NCMEMORY_H
+
+#include <stddef.h>
+
+/*
+ * Allocation layer of NumC, every library allocation goes through NC_MALLOC / NC_FREE and friends.
+ *
+ * memory_set_allocator routes them onto a user allocator; install it before anything is allocated,
+ * since a block must be released by the allocator that made it. Alignments up to
+ * MEMORY_MAX_ALIGNMENT are supported, zero asks for the natural malloc alignment.
+ *
+ * With NUMC_MEMORY defined every block also carries a header recording its size and call site:
+ * live bytes, high-water mark and allocation counts are kept per call site and per subsystem, and
+ * blocks still live at exit are reported. Without it the NC_MEMORY_* macros expand to nothing.
+ */
+
+#define MEMORY_MAX_ALIGNMENT 64 // largest alignment an allocation may ask for
+
+#define NC_MALLOC(size, subsystem) memory_allocate((size), 0, (subsystem), __FILE__, __LINE__)
+#define NC_CALLOC(amount, size, subsystem) memory_zero_allocate((amount), (size), (subsystem), __FILE__, __LINE__)
+#define NC_ALIGNED_ALLOC(alignment, size, subsystem) memory_allocate((size), (alignment), (subsystem), __FILE__, __LINE__)
+#define NC_REALLOC(pointer, size, subsystem) memory_reallocate((pointer), (size), (subsystem), __FILE__, __LINE__)
+#define NC_FREE(pointer) memory_release(pointer)
+
+typedef struct
+{
+    void* (*allocate)(void* user, size_t size, size_t alignment);
+    void* (*reallocate)(void* user, void* pointer, size_t size);
+    void (*release)(void* user, void* pointer);
+    void* user;
+} NCAllocator; // NumC Allocator structure that contain: allocation, reallocation of naturally aligned blocks and release hooks, user data passed to each of them
+
+void memory_set_allocator(const NCAllocator* allocator); // routes all following allocations onto given allocator, NULL restores malloc
+NCAllocator memory_allocator(void); // returns the current allocator
+
+void* memory_allocate(size_t size, size_t alignment, const char* subsystem, const char* file, int line); // allocates a block, returns NULL when the allocator fails
+void* memory_zero_allocate(size_t amount, size_t size, const char* subsystem, const char* file, int line); // allocates a zero-filled block of amount x size bytes
+void* memory_reallocate(void* pointer, size_t size, const char* subsystem, const char* file, int line); // resizes a naturally aligned block, returns NULL and keeps it when the allocator fails
+void memory_release(void* pointer); // releases a block, NULL is ignored
+
+#ifdef NUMC_MEMORY
+
+typedef struct
+{
+    size_t live_bytes;
+    size_t peak_bytes;
+    size_t live_blocks;
+    unsigned long long allocations;
+    unsigned long long releases;
+} NCMemoryStats; // NumC Memory stats structure that contain: bytes in use, their high-water mark, blocks in use, allocations and releases made
+
+NCMemoryStats memory_stats(void); // returns the counters of all allocations
+NCMemoryStats memory_subsystem_stats(const char* subsystem); // returns the counters of one subsystem, zeros when it never allocated
+void memory_print_summary(void); // prints a per-subsystem and per-call-site table of the counters
+size_t memory_report_leaks(void); // prints live blocks grouped by call site, returns their amount
+void memory_reset_peak(void); // restarts high-water marks from the bytes currently live
+
+#define NC_MEMORY_PRINT_SUMMARY() memory_print_summary()
+#define NC_MEMORY_REPORT_LEAKS() memory_report_leaks()
+#define NC_MEMORY_RESET_PEAK() memory_reset_peak()
+
+#else
+
+#define NC_MEMORY_PRINT_SUMMARY() ((void)0)
+#define NC_MEMORY_REPORT_LEAKS() (0)
+#define NC_MEMORY_RESET_PEAK() ((void)0)
+
+#endif // NUMC_MEMORY
+
+#endif // NCMEMORY_H
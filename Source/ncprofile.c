@@ -0,0 +1,262 @@
+#include "ncprofile.h"
+
+#ifdef NUMC_PROFILE
+
+#include <assert.h>
+#include <malloc.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#define PROFILE_INITIAL_EVENTS 1024
+#define PROFILE_MAX_OPERATIONS 128
+
+typedef struct
+{
+    const char* name;
+    double flops;
+    double bytes;
+    unsigned long long start;
+    unsigned long long duration;
+} NCProfileEvent; // NumC Profile event structure that contain: operation name, estimated work, start and duration in nanoseconds
+
+typedef struct NCProfileBuffer
+{
+    size_t thread_index;
+    size_t events_amount;
+    size_t events_capacity;
+    NCProfileEvent* events;
+    struct NCProfileBuffer* next;
+} NCProfileBuffer; // NumC Profile buffer structure that contain: owning thread index and events recorded by that thread
+
+typedef struct
+{
+    const char* name;
+    size_t calls;
+    unsigned long long total;
+    unsigned long long minimum;
+    unsigned long long maximum;
+    double flops;
+    double bytes;
+} NCProfileOperation; // NumC Profile operation structure that contain: merged counters of one operation over all threads
+
+static pthread_mutex_t buffers_mutex = PTHREAD_MUTEX_INITIALIZER;
+static NCProfileBuffer* buffers_head = NULL;
+static size_t buffers_amount = 0;
+static unsigned long long profile_origin = 0;
+
+static _Thread_local NCProfileBuffer* local_buffer = NULL;
+
+static unsigned long long profile_now(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return (unsigned long long)now.tv_sec * 1000000000ULL + (unsigned long long)now.tv_nsec;
+}
+
+static NCProfileBuffer* profile_local_buffer(void)
+{
+    if (local_buffer != NULL)
+    {
+        return local_buffer;
+    }
+
+    NCProfileBuffer* buffer = malloc(sizeof(*buffer));
+    assert(buffer != NULL);
+
+    buffer->events_amount = 0;
+    buffer->events_capacity = PROFILE_INITIAL_EVENTS;
+    buffer->events = malloc(sizeof(*buffer->events) * buffer->events_capacity);
+    assert(buffer->events != NULL);
+
+    pthread_mutex_lock(&buffers_mutex);
+
+    if (profile_origin == 0)
+    {
+        profile_origin = profile_now();
+    }
+
+    buffer->thread_index = buffers_amount++;
+    buffer->next = buffers_head;
+    buffers_head = buffer;
+
+    pthread_mutex_unlock(&buffers_mutex);
+
+    local_buffer = buffer;
+
+    return buffer;
+}
+
+NCProfileScope profile_begin(const char* name, double flops, double bytes)
+{
+    NCProfileScope scope;
+
+    profile_local_buffer();
+
+    scope.name = name;
+    scope.flops = flops;
+    scope.bytes = bytes;
+    scope.start = profile_now();
+
+    return scope;
+}
+
+void profile_end(NCProfileScope scope)
+{
+    unsigned long long end = profile_now();
+    NCProfileBuffer* buffer = profile_local_buffer();
+
+    if (buffer->events_amount == buffer->events_capacity)
+    {
+        buffer->events_capacity *= 2;
+        buffer->events = realloc(buffer->events, sizeof(*buffer->events) * buffer->events_capacity);
+
+        assert(buffer->events != NULL);
+    }
+
+    NCProfileEvent* event = &buffer->events[buffer->events_amount++];
+
+    event->name = scope.name;
+    event->flops = scope.flops;
+    event->bytes = scope.bytes;
+    event->start = scope.start;
+    event->duration = end - scope.start;
+}
+
+static size_t profile_merge(NCProfileOperation* operations)
+{
+    size_t operations_amount = 0;
+
+    for (NCProfileBuffer* buffer = buffers_head; buffer != NULL; buffer = buffer->next)
+    {
+        for (size_t i = 0; i < buffer->events_amount; ++i)
+        {
+            NCProfileEvent event = buffer->events[i];
+            size_t index = 0;
+
+            while (index < operations_amount && strcmp(operations[index].name, event.name) != 0)
+            {
+                ++index;
+            }
+
+            if (index == operations_amount)
+            {
+                assert((operations_amount < PROFILE_MAX_OPERATIONS) && "Too many distinct profiled operations!");
+
+                operations[index].name = event.name;
+                operations[index].calls = 0;
+                operations[index].total = 0;
+                operations[index].minimum = event.duration;
+                operations[index].maximum = event.duration;
+                operations[index].flops = 0;
+                operations[index].bytes = 0;
+
+                ++operations_amount;
+            }
+
+            NCProfileOperation* operation = &operations[index];
+
+            operation->calls += 1;
+            operation->total += event.duration;
+            operation->flops += event.flops;
+            operation->bytes += event.bytes;
+
+            if (event.duration < operation->minimum) operation->minimum = event.duration;
+            if (event.duration > operation->maximum) operation->maximum = event.duration;
+        }
+    }
+
+    return operations_amount;
+}
+
+void profile_print_summary(void)
+{
+    NCProfileOperation operations[PROFILE_MAX_OPERATIONS];
+
+    pthread_mutex_lock(&buffers_mutex);
+    size_t operations_amount = profile_merge(operations);
+    size_t threads_amount = buffers_amount;
+    pthread_mutex_unlock(&buffers_mutex);
+
+    printf("NumC profile (%zu threads)\n", threads_amount);
+    printf("%-32s %10s %12s %12s %12s %12s %10s %10s\n",
+           "operation", "calls", "total ms", "mean us", "min us", "max us", "GFLOP/s", "GB/s");
+
+    for (size_t i = 0; i < operations_amount; ++i)
+    {
+        NCProfileOperation operation = operations[i];
+        double seconds = (double)operation.total * 1e-9;
+
+        printf("%-32s %10zu %12.3f %12.3f %12.3f %12.3f %10.3f %10.3f\n",
+               operation.name,
+               operation.calls,
+               (double)operation.total * 1e-6,
+               (double)operation.total * 1e-3 / (double)operation.calls,
+               (double)operation.minimum * 1e-3,
+               (double)operation.maximum * 1e-3,
+               seconds > 0 ? operation.flops / seconds * 1e-9 : 0.0,
+               seconds > 0 ? operation.bytes / seconds * 1e-9 : 0.0);
+    }
+
+    printf("\n");
+}
+
+int profile_dump_trace(const char* path)
+{
+    FILE* file = fopen(path, "w");
+
+    if (file == NULL)
+    {
+        return -1;
+    }
+
+    pthread_mutex_lock(&buffers_mutex);
+
+    fprintf(file, "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n");
+
+    int first = 1;
+
+    for (NCProfileBuffer* buffer = buffers_head; buffer != NULL; buffer = buffer->next)
+    {
+        fprintf(file, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":%zu,\"args\":{\"name\":\"numc-%zu\"}}",
+                first ? "" : ",\n", buffer->thread_index, buffer->thread_index);
+        first = 0;
+
+        for (size_t i = 0; i < buffer->events_amount; ++i)
+        {
+            NCProfileEvent event = buffer->events[i];
+
+            fprintf(file, ",\n{\"name\":\"%s\",\"cat\":\"numc\",\"ph\":\"X\",\"pid\":0,\"tid\":%zu,\"ts\":%.3f,\"dur\":%.3f,\"args\":{\"flops\":%.0f,\"bytes\":%.0f}}",
+                    event.name,
+                    buffer->thread_index,
+                    ((double)event.start - (double)profile_origin) * 1e-3,
+                    (double)event.duration * 1e-3,
+                    event.flops,
+                    event.bytes);
+        }
+    }
+
+    fprintf(file, "\n]}\n");
+
+    pthread_mutex_unlock(&buffers_mutex);
+
+    return fclose(file) == 0 ? 0 : -1;
+}
+
+void profile_reset(void)
+{
+    pthread_mutex_lock(&buffers_mutex);
+
+    for (NCProfileBuffer* buffer = buffers_head; buffer != NULL; buffer = buffer->next)
+    {
+        buffer->events_amount = 0;
+    }
+
+    profile_origin = profile_now();
+
+    pthread_mutex_unlock(&buffers_mutex);
+}
+
+#endif // NUMC_PROFILE
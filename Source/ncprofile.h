@@ -0,0 +1,46 @@
+#ifndef NCPROFILE_H
+#define NCPROFILE_H
+
+#include <stddef.h>
+
+/*
+ * Per-operation profiling counters, compiled in only when NUMC_PROFILE is defined.
+ * Without it every NC_PROFILE_* macro expands to nothing, so arguments are never evaluated.
+ *
+ * Each thread records into its own buffer; buffers are merged when a summary or trace is dumped,
+ * so dump only while profiled threads are idle.
+ */
+
+#ifdef NUMC_PROFILE
+
+typedef struct
+{
+    const char* name;
+    double flops;
+    double bytes;
+    unsigned long long start;
+} NCProfileScope; // NumC Profile scope structure that contain: operation name, estimated FLOPs and bytes moved, start timestamp in nanoseconds
+
+NCProfileScope profile_begin(const char* name, double flops, double bytes); // opens a profiled scope on the calling thread
+void profile_end(NCProfileScope scope); // closes a profiled scope and records it into the calling thread buffer
+void profile_print_summary(void); // prints a per-operation table of calls, time, GFLOP/s and GB/s merged over all threads
+int profile_dump_trace(const char* path); // writes all recorded scopes as Chrome / Perfetto trace JSON, returns 0 on success
+void profile_reset(void); // drops all recorded scopes
+
+#define NC_PROFILE_BEGIN(name, flops, bytes) NCProfileScope nc_profile_scope = profile_begin((name), (double)(flops), (double)(bytes))
+#define NC_PROFILE_END() profile_end(nc_profile_scope)
+#define NC_PROFILE_PRINT_SUMMARY() profile_print_summary()
+#define NC_PROFILE_DUMP_TRACE(path) profile_dump_trace(path)
+#define NC_PROFILE_RESET() profile_reset()
+
+#else
+
+#define NC_PROFILE_BEGIN(name, flops, bytes) ((void)0)
+#define NC_PROFILE_END() ((void)0)
+#define NC_PROFILE_PRINT_SUMMARY() ((void)0)
+#define NC_PROFILE_DUMP_TRACE(path) (0)
+#define NC_PROFILE_RESET() ((void)0)
+
+#endif // NUMC_PROFILE
+
+#endif // NCPROFILE_H
@@ -0,0 +1,398 @@
+#include "ncquant.h"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif // __AVX2__
+
+#define QUANT_COMPARE_REPEATS 5 // forward passes timed per model, the fastest one is reported
+
+typedef struct
+{
+    const NCQuantLayer* layer;
+    NCMatrix input;
+    NCMatrix output;
+    uint8_t* quantized;
+    int32_t* accumulated;
+    size_t tasks_amount;
+} NCQuantContext; // NumC Quant context structure that contain: layer, its double input and output batches and int buffers of the current forward pass
+
+static double quant_seconds(void)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return (double)now.tv_sec + 1e-9 * (double)now.tv_nsec;
+}
+
+static size_t quant_round_up(size_t value, size_t multiple)
+{
+    return (value + multiple - 1) / multiple * multiple;
+}
+
+// position of weight ( input, output ) in the packed blocks
+static size_t quant_packed_at(const NCQuantLayer* layer, size_t input, size_t output)
+{
+    size_t groups = layer->inputs_padded / QUANT_GROUP_INPUTS;
+    size_t block = output / QUANT_BLOCK_OUTPUTS;
+    size_t group = input / QUANT_GROUP_INPUTS;
+
+    return ((block * groups + group) * QUANT_BLOCK_OUTPUTS + output % QUANT_BLOCK_OUTPUTS) * QUANT_GROUP_INPUTS + input % QUANT_GROUP_INPUTS;
+}
+
+static NCQuantLayer quant_layer_create(NCMatrix weight, double minimum, double maximum, function_type activation)
+{
+    NCQuantLayer layer;
+
+    layer.inputs = weight.rows;
+    layer.outputs = weight.columns;
+    layer.inputs_padded = quant_round_up(weight.rows, QUANT_GROUP_INPUTS);
+    layer.outputs_padded = quant_round_up(weight.columns, QUANT_BLOCK_OUTPUTS);
+    layer.activation = activation;
+
+    layer.weights = NC_ALIGNED_ALLOC(32, quant_round_up(layer.inputs_padded * layer.outputs_padded, 32), "quant");
+    layer.column_sums = NC_MALLOC(sizeof(*layer.column_sums) * layer.outputs, "quant");
+    layer.weight_scales = NC_MALLOC(sizeof(*layer.weight_scales) * layer.outputs, "quant");
+
+    assert(layer.weights != NULL && layer.column_sums != NULL && layer.weight_scales != NULL);
+
+    memset(layer.weights, 0, layer.inputs_padded * layer.outputs_padded);
+
+    for (size_t j = 0; j < layer.outputs; ++j)
+    {
+        double largest = 0;
+
+        for (size_t k = 0; k < layer.inputs; ++k)
+        {
+            largest = fmax(largest, fabs(MAT_AT(weight, k, j)));
+        }
+
+        double scale = largest > 0 ? largest / QUANT_LEVELS : 1.0;
+        int32_t sum = 0;
+
+        for (size_t k = 0; k < layer.inputs; ++k)
+        {
+            int8_t value = (int8_t)lrint(MAT_AT(weight, k, j) / scale);
+
+            layer.weights[quant_packed_at(&layer, k, j)] = value;
+            sum += value;
+        }
+
+        layer.weight_scales[j] = scale;
+        layer.column_sums[j] = sum;
+    }
+
+    layer.input_minimum = minimum;
+    layer.input_scale = maximum > minimum ? (maximum - minimum) / QUANT_LEVELS : 1.0;
+
+    return layer;
+}
+
+// int32 products of up to QUANT_BLOCK_ROWS quantized rows with the packed Weight, missing rows repeat the first one
+static void quant_dot_rows(const NCQuantLayer* layer, const uint8_t* const* rows, int32_t* const* outputs, size_t rows_amount)
+{
+    size_t groups = layer->inputs_padded / QUANT_GROUP_INPUTS;
+    size_t blocks = layer->outputs_padded / QUANT_BLOCK_OUTPUTS;
+
+#if defined(__AVX2__)
+    const __m256i ones = _mm256_set1_epi16(1);
+
+    for (size_t block = 0; block < blocks; ++block)
+    {
+        const int8_t* weights = layer->weights + block * groups * QUANT_BLOCK_OUTPUTS * QUANT_GROUP_INPUTS;
+        __m256i accumulators[QUANT_BLOCK_ROWS];
+
+        for (size_t r = 0; r < QUANT_BLOCK_ROWS; ++r)
+        {
+            accumulators[r] = _mm256_setzero_si256();
+        }
+
+        for (size_t group = 0; group < groups; ++group)
+        {
+            __m256i weight = _mm256_load_si256((const __m256i*)(weights + group * QUANT_BLOCK_OUTPUTS * QUANT_GROUP_INPUTS));
+
+            for (size_t r = 0; r < QUANT_BLOCK_ROWS; ++r)
+            {
+                int32_t packed;
+
+                memcpy(&packed, rows[r] + group * QUANT_GROUP_INPUTS, sizeof(packed));
+
+                // u7 x s8 pairs stay inside 16 bits, so maddubs never saturates
+                __m256i products = _mm256_maddubs_epi16(_mm256_set1_epi32(packed), weight);
+
+                accumulators[r] = _mm256_add_epi32(accumulators[r], _mm256_madd_epi16(products, ones));
+            }
+        }
+
+        for (size_t r = 0; r < rows_amount; ++r)
+        {
+            _mm256_storeu_si256((__m256i*)(outputs[r] + block * QUANT_BLOCK_OUTPUTS), accumulators[r]);
+        }
+    }
+#else
+    for (size_t block = 0; block < blocks; ++block)
+    {
+        const int8_t* weights = layer->weights + block * groups * QUANT_BLOCK_OUTPUTS * QUANT_GROUP_INPUTS;
+
+        for (size_t r = 0; r < rows_amount; ++r)
+        {
+            int32_t accumulators[QUANT_BLOCK_OUTPUTS] = { 0 };
+
+            for (size_t group = 0; group < groups; ++group)
+            {
+                const uint8_t* input = rows[r] + group * QUANT_GROUP_INPUTS;
+                const int8_t* weight = weights + group * QUANT_BLOCK_OUTPUTS * QUANT_GROUP_INPUTS;
+
+                for (size_t k = 0; k < QUANT_GROUP_INPUTS; ++k)
+                {
+                    int32_t value = input[k];
+
+                    for (size_t lane = 0; lane < QUANT_BLOCK_OUTPUTS; ++lane)
+                    {
+                        accumulators[lane] += value * (int32_t)weight[lane * QUANT_GROUP_INPUTS + k];
+                    }
+                }
+            }
+
+            memcpy(outputs[r] + block * QUANT_BLOCK_OUTPUTS, accumulators, sizeof(accumulators));
+        }
+    }
+#endif // __AVX2__
+}
+
+static void quant_forward_task(void* argument, size_t task)
+{
+    NCQuantContext* context = argument;
+    const NCQuantLayer* layer = context->layer;
+
+    size_t begin = task * context->input.rows / context->tasks_amount;
+    size_t end = (task + 1) * context->input.rows / context->tasks_amount;
+    double inverse_scale = 1.0 / layer->input_scale;
+
+    for (size_t row = begin; row < end; ++row)
+    {
+        uint8_t* quantized = context->quantized + row * layer->inputs_padded;
+
+        for (size_t k = 0; k < layer->inputs; ++k)
+        {
+            double level = nearbyint((MAT_AT(context->input, row, k) - layer->input_minimum) * inverse_scale);
+
+            quantized[k] = (uint8_t)(level < 0 ? 0 : level > QUANT_LEVELS ? QUANT_LEVELS : level);
+        }
+
+        memset(quantized + layer->inputs, 0, layer->inputs_padded - layer->inputs);
+    }
+
+    for (size_t row = begin; row < end; row += QUANT_BLOCK_ROWS)
+    {
+        size_t rows_amount = end - row < QUANT_BLOCK_ROWS ? end - row : QUANT_BLOCK_ROWS;
+        const uint8_t* rows[QUANT_BLOCK_ROWS];
+        int32_t* outputs[QUANT_BLOCK_ROWS];
+
+        for (size_t r = 0; r < QUANT_BLOCK_ROWS; ++r)
+        {
+            size_t source = row + (r < rows_amount ? r : 0);
+
+            rows[r] = context->quantized + source * layer->inputs_padded;
+            outputs[r] = context->accumulated + source * layer->outputs_padded;
+        }
+
+        quant_dot_rows(layer, rows, outputs, rows_amount);
+    }
+
+    for (size_t row = begin; row < end; ++row)
+    {
+        const int32_t* accumulated = context->accumulated + row * layer->outputs_padded;
+
+        for (size_t j = 0; j < layer->outputs; ++j)
+        {
+            double value = layer->weight_scales[j] * (layer->input_scale * (double)accumulated[j] + layer->input_minimum * (double)layer->column_sums[j]);
+
+            MAT_AT(context->output, row, j) = layer->activation(value);
+        }
+    }
+}
+
+NCQuantPerceptron quant_perceptron_create(NCPerceptron model, NCMatrix calibration)
+{
+    size_t layers_amount = perceptron_number_of_layers(model);
+
+    assert((calibration.rows > 0 && calibration.columns == layer_at_length(model.layers, 0)) && "Calibration data and Input Layer are incompatible");
+
+    NCMatrix activations[layers_amount];
+
+    activations[0] = calibration;
+
+    for (size_t i = 1; i < layers_amount; ++i)
+    {
+        activations[i] = matrix_allocate(calibration.rows, layer_at_length(model.layers, i));
+    }
+
+    perceptron_forward_batch(model, activations);
+
+    NCQuantPerceptron quantized;
+
+    quantized.layers_amount = layers_amount - 1;
+    quantized.layers = NC_MALLOC(sizeof(*quantized.layers) * quantized.layers_amount, "quant");
+    quantized.scratch = arena_allocate(1);
+
+    assert(quantized.layers != NULL);
+
+    for (size_t i = 0; i < quantized.layers_amount; ++i)
+    {
+        quantized.layers[i] = quant_layer_create(perceptron_weight_at(model, i), matrix_min(activations[i]), matrix_max(activations[i]), perceptron_activation_at(model, i + 1));
+    }
+
+    for (size_t i = 1; i < layers_amount; ++i)
+    {
+        matrix_delete(activations[i]);
+    }
+
+    return quantized;
+}
+
+void quant_perceptron_forward_batch(NCQuantPerceptron model, NCMatrix destination, NCMatrix input)
+{
+    assert((input.columns == model.layers[0].inputs) && "Input columns and Input Layer are incompatible");
+    assert((destination.rows == input.rows && destination.columns == model.layers[model.layers_amount - 1].outputs) && "Destination dimensions must be correct!");
+
+    NC_PROFILE_BEGIN("quant_perceptron_forward_batch", 0, 0);
+
+    size_t threads_amount = thread_pool_default()->threads_amount;
+
+    NCQuantContext context;
+
+    context.input = input;
+    context.tasks_amount = input.rows < threads_amount ? (input.rows > 0 ? input.rows : 1) : threads_amount;
+
+    arena_reset(model.scratch);
+
+    for (size_t i = 0; i < model.layers_amount; ++i)
+    {
+        const NCQuantLayer* layer = &model.layers[i];
+
+        context.layer = layer;
+        context.output = i + 1 == model.layers_amount ? destination : arena_matrix(model.scratch, input.rows, layer->outputs);
+        context.quantized = (uint8_t*)arena_push(model.scratch, (input.rows * layer->inputs_padded + sizeof(double) - 1) / sizeof(double));
+        context.accumulated = (int32_t*)arena_push(model.scratch, (input.rows * layer->outputs_padded * sizeof(int32_t) + sizeof(double) - 1) / sizeof(double));
+
+        thread_pool_run(thread_pool_default(), quant_forward_task, &context, context.tasks_amount);
+
+        context.input = context.output;
+    }
+
+    NC_PROFILE_END();
+}
+
+NCQuantReport quant_perceptron_compare(NCPerceptron model, NCQuantPerceptron quantized, NCMatrix samples)
+{
+    size_t layers_amount = perceptron_number_of_layers(model);
+
+    NCMatrix activations[layers_amount];
+    NCMatrix output = matrix_allocate(samples.rows, quantized.layers[quantized.layers_amount - 1].outputs);
+
+    activations[0] = samples;
+
+    for (size_t i = 1; i < layers_amount; ++i)
+    {
+        activations[i] = matrix_allocate(samples.rows, layer_at_length(model.layers, i));
+    }
+
+    NCQuantReport report;
+
+    report.samples_amount = samples.rows;
+    report.double_seconds = INFINITY;
+    report.quant_seconds = INFINITY;
+
+    for (size_t repeat = 0; repeat < QUANT_COMPARE_REPEATS; ++repeat)
+    {
+        double start = quant_seconds();
+
+        perceptron_forward_batch(model, activations);
+
+        double middle = quant_seconds();
+
+        quant_perceptron_forward_batch(quantized, output, samples);
+
+        double end = quant_seconds();
+
+        report.double_seconds = fmin(report.double_seconds, middle - start);
+        report.quant_seconds = fmin(report.quant_seconds, end - middle);
+    }
+
+    NCMatrix reference = activations[layers_amount - 1];
+    size_t agreements = 0;
+
+    report.max_abs_error = 0;
+    report.mean_abs_error = 0;
+
+    for (size_t row = 0; row < samples.rows; ++row)
+    {
+        NCVector expected = { reference.columns, &MAT_AT(reference, row, 0) };
+        NCVector actual = { output.columns, &MAT_AT(output, row, 0) };
+
+        for (size_t j = 0; j < output.columns; ++j)
+        {
+            double error = fabs(VEC_AT(expected, j) - VEC_AT(actual, j));
+
+            report.max_abs_error = fmax(report.max_abs_error, error);
+            report.mean_abs_error += error;
+        }
+
+        agreements += vector_argmax(expected) == vector_argmax(actual);
+    }
+
+    report.mean_abs_error /= (double)(samples.rows * output.columns);
+    report.argmax_agreement = (double)agreements / (double)samples.rows;
+
+    report.double_weight_bytes = 0;
+    report.quant_weight_bytes = 0;
+
+    for (size_t i = 0; i < quantized.layers_amount; ++i)
+    {
+        const NCQuantLayer* layer = &quantized.layers[i];
+
+        report.double_weight_bytes += sizeof(double) * layer->inputs * layer->outputs;
+        report.quant_weight_bytes += layer->inputs_padded * layer->outputs_padded + (sizeof(*layer->column_sums) + sizeof(*layer->weight_scales)) * layer->outputs;
+    }
+
+    for (size_t i = 1; i < layers_amount; ++i)
+    {
+        matrix_delete(activations[i]);
+    }
+
+    matrix_delete(output);
+
+    return report;
+}
+
+void quant_report_print(NCQuantReport report)
+{
+    printf("Quantized inference ( %s kernel ) on %zu samples\n", quant_kernel_name(), report.samples_amount);
+    printf("    output error: max %.6g, mean %.6g\n", report.max_abs_error, report.mean_abs_error);
+    printf("    argmax agreement: %.2f%%\n", 100.0 * report.argmax_agreement);
+    printf("    forward: double %.3f ms, int8 %.3f ms, speedup %.2fx\n", 1e3 * report.double_seconds, 1e3 * report.quant_seconds, report.double_seconds / report.quant_seconds);
+    printf("    weights: double %zu bytes, int8 %zu bytes, %.2fx smaller\n", report.double_weight_bytes, report.quant_weight_bytes, (double)report.double_weight_bytes / (double)report.quant_weight_bytes);
+}
+
+const char* quant_kernel_name(void)
+{
+#if defined(__AVX2__)
+    return "avx2";
+#else
+    return "scalar";
+#endif // __AVX2__
+}
+
+void quant_perceptron_delete(NCQuantPerceptron model)
+{
+    for (size_t i = 0; i < model.layers_amount; ++i)
+    {
+        NC_FREE(model.layers[i].weights);
+        NC_FREE(model.layers[i].column_sums);
+        NC_FREE(model.layers[i].weight_scales);
+    }
+
+    NC_FREE(model.layers);
+    arena_delete(model.scratch);
+}
@@ -0,0 +1,70 @@
+#ifndef NCQUANT_H
+#define NCQUANT_H
+
+#include <stdint.h>
+
+#include "numc.h"
+#include "ncarena.h"
+#include "ncthread.h"
+
+/*
+ * Post-training int8 quantization of NCPerceptron for inference.
+ *
+ * Every Weight column, one per output neuron, gets its own scale so that its largest magnitude
+ * maps to 127. Layer inputs are quantized asymmetrically from the range seen on a calibration
+ * batch to unsigned 7-bit values: with inputs in [0, 127] a pair of u8 x s8 products summed into
+ * 16 bits stays below 32767, so the AVX2 vpmaddubsw / vpmaddwd kernel never saturates and gives
+ * exactly the scalar fallback results. With x = input_scale * q + input_minimum,
+ *
+ *     output_j = input_scale * weight_scale_j * sum_k q_k w_kj + input_minimum * weight_scale_j * sum_k w_kj
+ *
+ * where the second sum is precomputed per column. Weights are packed in blocks of
+ * QUANT_BLOCK_OUTPUTS outputs by QUANT_GROUP_INPUTS inputs, zero-padded at the edges.
+ */
+
+#define QUANT_LEVELS 127 // largest quantized input and weight magnitude
+#define QUANT_GROUP_INPUTS 4 // inputs summed into one 32-bit lane by a vpmaddubsw / vpmaddwd pair
+#define QUANT_BLOCK_OUTPUTS 8 // 32-bit lanes of an AVX2 register
+#define QUANT_BLOCK_ROWS 4 // batch rows sharing each loaded weight block
+
+typedef struct
+{
+    size_t inputs;
+    size_t outputs;
+    size_t inputs_padded;
+    size_t outputs_padded;
+    int8_t* weights;
+    int32_t* column_sums;
+    double* weight_scales;
+    double input_scale;
+    double input_minimum;
+    function_type activation;
+} NCQuantLayer; // NumC Quant layer structure that contain: Weight shape and padded shape, packed int8 Weight, per-output sums and scales, input quantization and output activation
+
+typedef struct
+{
+    size_t layers_amount;
+    NCQuantLayer* layers;
+    NCArena* scratch;
+} NCQuantPerceptron; // NumC Quant perceptron structure that contain: amount of quantized Weights, quantized layers and scratch arena for forward passes
+
+typedef struct
+{
+    size_t samples_amount;
+    double max_abs_error;
+    double mean_abs_error;
+    double argmax_agreement;
+    double double_seconds;
+    double quant_seconds;
+    size_t double_weight_bytes;
+    size_t quant_weight_bytes;
+} NCQuantReport; // NumC Quant report structure that contain: amount of compared samples, output errors, share of equal argmax, forward times and Weight sizes of both models
+
+NCQuantPerceptron quant_perceptron_create(NCPerceptron model, NCMatrix calibration); // quantizes model Weights and calibrates input ranges on a ( samples x inputs ) batch
+void quant_perceptron_forward_batch(NCQuantPerceptron model, NCMatrix destination, NCMatrix input); // propagates a ( batch x inputs ) Matrix through the quantized model into ( batch x outputs ) destination
+NCQuantReport quant_perceptron_compare(NCPerceptron model, NCQuantPerceptron quantized, NCMatrix samples); // runs both models on a batch and measures accuracy, speed and size
+void quant_report_print(NCQuantReport report); // prints a comparison report
+const char* quant_kernel_name(void); // returns the name of the compiled int8 kernel
+void quant_perceptron_delete(NCQuantPerceptron model); // deletes the quantized model
+
+#endif // NCQUANT_H
@@ -0,0 +1,216 @@
+#include "ncsampling.h"
+
+#define SAMPLING_JUMP_RATIO 0.75 // share of the parent interval change above which a max-depth interval is a jump
+
+typedef struct
+{
+    const function_type* functions;
+    NCSamples* partial;
+    double start;
+    double end;
+    size_t chunks_amount;
+    NCSamplingConfig config;
+} NCSamplingContext; // NumC Sampling context structure that contain: functions, per-task samples and the sampled range
+
+NCSamples samples_allocate(size_t capacity)
+{
+    NCSamples samples;
+
+    samples.length = 0;
+    samples.capacity = capacity > 0 ? capacity : 1;
+    samples.X = NC_MALLOC(sizeof(*samples.X) * samples.capacity, "sampling");
+    samples.Y = NC_MALLOC(sizeof(*samples.Y) * samples.capacity, "sampling");
+    samples.connected = NC_MALLOC(sizeof(*samples.connected) * samples.capacity, "sampling");
+
+    assert(samples.X != NULL && samples.Y != NULL && samples.connected != NULL);
+
+    return samples;
+}
+
+void samples_push(NCSamples* samples, double x, double y)
+{
+    if (samples->length == samples->capacity)
+    {
+        samples->capacity *= 2;
+        samples->X = NC_REALLOC(samples->X, sizeof(*samples->X) * samples->capacity, "sampling");
+        samples->Y = NC_REALLOC(samples->Y, sizeof(*samples->Y) * samples->capacity, "sampling");
+        samples->connected = NC_REALLOC(samples->connected, sizeof(*samples->connected) * samples->capacity, "sampling");
+
+        assert(samples->X != NULL && samples->Y != NULL && samples->connected != NULL);
+    }
+
+    samples->X[samples->length] = x;
+    samples->Y[samples->length] = y;
+    samples->connected[samples->length] = 0;
+    samples->length += 1;
+}
+
+static double sampling_grid_at(double start, double end, size_t intervals, size_t index)
+{
+    return index == intervals ? end : start + (end - start) * (double)index / (double)intervals;
+}
+
+// appends points of (x0, x1] after x0, which must be the last pushed point, and links each to its predecessor
+static void sampling_refine(NCSamples* samples, function_type function, double x0, double y0, double x1, double y1, double parent_change, size_t depth, NCSamplingConfig config)
+{
+    int finite = isfinite(y0) && isfinite(y1);
+    double change = fabs(y1 - y0);
+
+    if (depth == config.max_depth || (!isfinite(y0) && !isfinite(y1)))
+    {
+        int jump = finite && change > config.jump && change > SAMPLING_JUMP_RATIO * parent_change;
+
+        samples->connected[samples->length - 1] = finite && !jump;
+        samples_push(samples, x1, y1);
+
+        return;
+    }
+
+    double xm = 0.5 * (x0 + x1);
+    double ym = function(xm);
+
+    int hidden = (y0 > config.maximum && ym > config.maximum && y1 > config.maximum) ||
+                 (y0 < config.minimum && ym < config.minimum && y1 < config.minimum);
+
+    if (finite && isfinite(ym) && (hidden || fabs(ym - 0.5 * (y0 + y1)) <= config.tolerance))
+    {
+        samples->connected[samples->length - 1] = 1;
+        samples_push(samples, xm, ym);
+        samples->connected[samples->length - 1] = 1;
+        samples_push(samples, x1, y1);
+
+        return;
+    }
+
+    sampling_refine(samples, function, x0, y0, xm, ym, change, depth + 1, config);
+    sampling_refine(samples, function, xm, ym, x1, y1, change, depth + 1, config);
+}
+
+// samples grid intervals [first, last) of one function, including both grid ends
+static NCSamples sampling_chunk(function_type function, double start, double end, size_t first, size_t last, NCSamplingConfig config)
+{
+    size_t intervals = config.grid_points - 1;
+    NCSamples samples = samples_allocate(2 * (last - first) + 1);
+
+    double x0 = sampling_grid_at(start, end, intervals, first);
+    double y0 = function(x0);
+
+    samples_push(&samples, x0, y0);
+
+    for (size_t i = first; i < last; ++i)
+    {
+        double x1 = sampling_grid_at(start, end, intervals, i + 1);
+        double y1 = function(x1);
+
+        sampling_refine(&samples, function, x0, y0, x1, y1, INFINITY, 0, config);
+
+        x0 = x1;
+        y0 = y1;
+    }
+
+    return samples;
+}
+
+static void sampling_task(void* argument, size_t task)
+{
+    NCSamplingContext* context = argument;
+
+    size_t function_index = task / context->chunks_amount;
+    size_t chunk = task % context->chunks_amount;
+    size_t intervals = context->config.grid_points - 1;
+
+    size_t first = chunk * intervals / context->chunks_amount;
+    size_t last = (chunk + 1) * intervals / context->chunks_amount;
+
+    context->partial[task] = sampling_chunk(context->functions[function_index], context->start, context->end, first, last, context->config);
+}
+
+NCSamplingConfig sampling_config(size_t pixels)
+{
+    NCSamplingConfig config;
+
+    config.grid_points = pixels + 1;
+    config.max_depth = 10;
+    config.tolerance = 0.25;
+    config.jump = 2.0;
+    config.minimum = -INFINITY;
+    config.maximum = INFINITY;
+
+    return config;
+}
+
+NCSamples sampling_adaptive(function_type function, double start, double end, NCSamplingConfig config)
+{
+    NCSamples samples;
+
+    sampling_adaptive_many(&samples, 1, &function, start, end, config);
+
+    return samples;
+}
+
+void sampling_adaptive_many(NCSamples* destination, size_t functions_amount, const function_type* functions, double start, double end, NCSamplingConfig config)
+{
+    assert((config.grid_points >= 2) && "Sampling grid needs at least both ends!");
+    assert((start < end) && "Sampling range must not be empty!");
+
+    NC_PROFILE_BEGIN("sampling_adaptive", 0, 0);
+
+    size_t intervals = config.grid_points - 1;
+    size_t threads_amount = thread_pool_default()->threads_amount;
+
+    NCSamplingContext context;
+
+    context.functions = functions;
+    context.start = start;
+    context.end = end;
+    context.config = config;
+    context.chunks_amount = intervals < threads_amount ? intervals : threads_amount;
+    context.partial = NC_MALLOC(sizeof(*context.partial) * functions_amount * context.chunks_amount, "sampling");
+
+    assert(context.partial != NULL);
+
+    thread_pool_run(thread_pool_default(), sampling_task, &context, functions_amount * context.chunks_amount);
+
+    // chunks share their boundary grid point, so every chunk after the first drops its first point
+    for (size_t function_index = 0; function_index < functions_amount; ++function_index)
+    {
+        NCSamples* chunks = context.partial + function_index * context.chunks_amount;
+        size_t length = 1;
+
+        for (size_t chunk = 0; chunk < context.chunks_amount; ++chunk)
+        {
+            length += chunks[chunk].length - 1;
+        }
+
+        NCSamples samples = samples_allocate(length);
+
+        samples_push(&samples, chunks[0].X[0], chunks[0].Y[0]);
+
+        for (size_t chunk = 0; chunk < context.chunks_amount; ++chunk)
+        {
+            size_t offset = samples.length - 1;
+            size_t amount = chunks[chunk].length - 1;
+
+            memcpy(samples.X + offset + 1, chunks[chunk].X + 1, sizeof(*samples.X) * amount);
+            memcpy(samples.Y + offset + 1, chunks[chunk].Y + 1, sizeof(*samples.Y) * amount);
+            memcpy(samples.connected + offset, chunks[chunk].connected, sizeof(*samples.connected) * (amount + 1));
+
+            samples.length += amount;
+
+            samples_delete(chunks[chunk]);
+        }
+
+        destination[function_index] = samples;
+    }
+
+    NC_FREE(context.partial);
+
+    NC_PROFILE_END();
+}
+
+void samples_delete(NCSamples samples)
+{
+    NC_FREE(samples.X);
+    NC_FREE(samples.Y);
+    NC_FREE(samples.connected);
+}
@@ -0,0 +1,46 @@
+#ifndef NCSAMPLING_H
+#define NCSAMPLING_H
+
+#include "ncmatrix.h"
+#include "ncthread.h"
+
+/*
+ * Adaptive sampling of functions for drawing. Sampling starts from a uniform grid, usually one
+ * point per pixel column, and halves a grid interval while its midpoint strays more than
+ * tolerance from the straight segment between its ends, up to max_depth times. An interval
+ * still steeper than jump at max_depth, which carries most of its parent change, is taken
+ * as a discontinuity and left unconnected, as is every interval touching a non-finite value.
+ * Intervals whose ends and midpoint all lie on one side outside [minimum, maximum] are not
+ * refined, so curves leaving the visible range cost nothing there.
+ *
+ * Smooth stretches cost one evaluation per grid point and bends get extra points only where
+ * they are. Grid intervals of every function are split into chunks on the default thread pool.
+ */
+
+typedef struct
+{
+    size_t grid_points;
+    size_t max_depth;
+    double tolerance;
+    double jump;
+    double minimum;
+    double maximum;
+} NCSamplingConfig; // NumC Sampling config structure that contain: uniform grid points including both ends, maximum halvings of a grid interval, allowed midpoint deviation, smallest vertical change treated as a jump and visible range of values
+
+typedef struct
+{
+    size_t length;
+    size_t capacity;
+    double* X;
+    double* Y;
+    unsigned char* connected;
+} NCSamples; // NumC Samples structure that contain: amount of points, allocated room, increasing X, values Y and connected[i] set when the curve continues from point i to point i + 1
+
+NCSamplingConfig sampling_config(size_t pixels); // returns a config with one grid interval per pixel, sub-pixel tolerance for plots in pixel units and unbounded visible range
+NCSamples sampling_adaptive(function_type function, double start, double end, NCSamplingConfig config); // samples one function over [start, end]
+void sampling_adaptive_many(NCSamples* destination, size_t functions_amount, const function_type* functions, double start, double end, NCSamplingConfig config); // samples every function over [start, end] into destination[i] in parallel
+NCSamples samples_allocate(size_t capacity); // allocates empty samples with room for capacity points
+void samples_push(NCSamples* samples, double x, double y); // appends an unconnected point, growing the room when needed
+void samples_delete(NCSamples samples); // deletes the samples
+
+#endif // NCSAMPLING_H
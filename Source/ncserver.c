@@ -0,0 +1,760 @@
+#include "ncserver.h"
+
+#include <errno.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0
+#endif // MSG_NOSIGNAL
+
+#define SERVER_HEADER_SIZE (sizeof(uint64_t) + sizeof(uint32_t))
+#define SERVER_LISTEN_BACKLOG 128
+
+struct NCServerRequest
+{
+    NCServerConnection* connection;
+    uint64_t id;
+    unsigned long long arrival;
+    NCServerRequest* next;
+    double input[];
+}; // NumC Server request structure that contain: originating connection, client id, arrival time in nanoseconds and input row
+
+struct NCServerConnection
+{
+    int fd;
+    size_t references;
+    pthread_mutex_t write_mutex;
+    NCServer* server;
+    NCServerConnection* next;
+}; // NumC Server connection structure that contain: client socket, references held by reader and queued requests, write lock
+
+typedef struct
+{
+    NCLoadConfig config;
+    unsigned long long seed;
+    unsigned long long received;
+    NCLatencyHistogram latency;
+} NCLoadClient; // NumC Load client structure that contain: load config, random seed, received responses and client-side latency
+
+static unsigned long long server_now(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return (unsigned long long)now.tv_sec * 1000000000ULL + (unsigned long long)now.tv_nsec;
+}
+
+static int read_exact(int fd, void* buffer, size_t length)
+{
+    char* bytes = buffer;
+
+    while (length > 0)
+    {
+        ssize_t received = recv(fd, bytes, length, 0);
+
+        if (received < 0 && errno == EINTR) continue;
+        if (received <= 0) return -1;
+
+        bytes += received;
+        length -= (size_t)received;
+    }
+
+    return 0;
+}
+
+static int write_exact(int fd, const void* buffer, size_t length)
+{
+    const char* bytes = buffer;
+
+    while (length > 0)
+    {
+        ssize_t sent = send(fd, bytes, length, MSG_NOSIGNAL);
+
+        if (sent < 0 && errno == EINTR) continue;
+        if (sent <= 0) return -1;
+
+        bytes += sent;
+        length -= (size_t)sent;
+    }
+
+    return 0;
+}
+
+static int read_header(int fd, uint64_t* id, uint32_t* length)
+{
+    unsigned char header[SERVER_HEADER_SIZE];
+
+    if (read_exact(fd, header, sizeof(header)) != 0) return -1;
+
+    memcpy(id, header, sizeof(*id));
+    memcpy(length, header + sizeof(*id), sizeof(*length));
+
+    return 0;
+}
+
+static int write_message(int fd, uint64_t id, const double* numbers, uint32_t length)
+{
+    unsigned char header[SERVER_HEADER_SIZE];
+
+    memcpy(header, &id, sizeof(id));
+    memcpy(header + sizeof(id), &length, sizeof(length));
+
+    if (write_exact(fd, header, sizeof(header)) != 0) return -1;
+
+    return write_exact(fd, numbers, sizeof(*numbers) * length);
+}
+
+void histogram_zero(NCLatencyHistogram* histogram)
+{
+    memset(histogram, 0, sizeof(*histogram));
+}
+
+static size_t histogram_index(unsigned long long microseconds)
+{
+    if (microseconds < SERVER_HISTOGRAM_SUB_BUCKETS)
+    {
+        return (size_t)microseconds;
+    }
+
+    size_t exponent = 0;
+
+    while ((microseconds >> (exponent + 1)) != 0)
+    {
+        ++exponent;
+    }
+
+    size_t sub_bucket = (size_t)(microseconds >> (exponent - 3)) & (SERVER_HISTOGRAM_SUB_BUCKETS - 1);
+    size_t index = (exponent - 2) * SERVER_HISTOGRAM_SUB_BUCKETS + sub_bucket;
+
+    return index < SERVER_HISTOGRAM_BUCKETS ? index : SERVER_HISTOGRAM_BUCKETS - 1;
+}
+
+static unsigned long long histogram_upper_bound(size_t index)
+{
+    if (index < SERVER_HISTOGRAM_SUB_BUCKETS)
+    {
+        return index;
+    }
+
+    size_t exponent = index / SERVER_HISTOGRAM_SUB_BUCKETS + 2;
+    unsigned long long sub_bucket = index % SERVER_HISTOGRAM_SUB_BUCKETS;
+    unsigned long long width = 1ULL << (exponent - 3);
+
+    return (SERVER_HISTOGRAM_SUB_BUCKETS + sub_bucket) * width + width - 1;
+}
+
+void histogram_record(NCLatencyHistogram* histogram, unsigned long long microseconds)
+{
+    histogram->buckets[histogram_index(microseconds)] += 1;
+    histogram->count += 1;
+
+    if (microseconds > histogram->maximum) histogram->maximum = microseconds;
+}
+
+void histogram_merge(NCLatencyHistogram* destination, const NCLatencyHistogram* source)
+{
+    for (size_t i = 0; i < SERVER_HISTOGRAM_BUCKETS; ++i)
+    {
+        destination->buckets[i] += source->buckets[i];
+    }
+
+    destination->count += source->count;
+
+    if (source->maximum > destination->maximum) destination->maximum = source->maximum;
+}
+
+double histogram_percentile(const NCLatencyHistogram* histogram, double percentile)
+{
+    assert((percentile >= 0 && percentile <= 1) && "Percentile must be in range [0, 1]");
+
+    if (histogram->count == 0)
+    {
+        return 0;
+    }
+
+    unsigned long long target = (unsigned long long)ceil(percentile * (double)histogram->count);
+    unsigned long long cumulative = 0;
+
+    if (target == 0) target = 1;
+
+    for (size_t i = 0; i < SERVER_HISTOGRAM_BUCKETS; ++i)
+    {
+        cumulative += histogram->buckets[i];
+
+        if (cumulative >= target)
+        {
+            unsigned long long bound = histogram_upper_bound(i);
+
+            return (double)(bound < histogram->maximum ? bound : histogram->maximum);
+        }
+    }
+
+    return (double)histogram->maximum;
+}
+
+static void connection_release(NCServerConnection* connection)
+{
+    NCServer* server = connection->server;
+
+    pthread_mutex_lock(&server->connections_mutex);
+    int last = --connection->references == 0;
+    pthread_mutex_unlock(&server->connections_mutex);
+
+    if (last)
+    {
+        close(connection->fd);
+        pthread_mutex_destroy(&connection->write_mutex);
+        NC_FREE(connection);
+    }
+}
+
+static void server_enqueue(NCServer* server, NCServerRequest* request)
+{
+    pthread_mutex_lock(&server->queue_mutex);
+
+    while (server->queue_length >= server->config.max_queue_length)
+    {
+        pthread_cond_wait(&server->queue_drained, &server->queue_mutex);
+    }
+
+    request->next = NULL;
+
+    if (server->queue_tail == NULL) server->queue_head = request;
+    else server->queue_tail->next = request;
+
+    server->queue_tail = request;
+    server->queue_length += 1;
+
+    pthread_cond_broadcast(&server->queue_filled);
+    pthread_mutex_unlock(&server->queue_mutex);
+}
+
+static void* server_reader(void* argument)
+{
+    NCServerConnection* connection = argument;
+    NCServer* server = connection->server;
+    size_t input_length = layer_at_length(server->model.layers, 0);
+
+    for (;;)
+    {
+        uint64_t id;
+        uint32_t length;
+
+        if (read_header(connection->fd, &id, &length) != 0) break;
+        if (length != input_length) break;
+
+        NCServerRequest* request = NC_MALLOC(sizeof(*request) + sizeof(*request->input) * input_length, "server");
+        assert(request != NULL);
+
+        if (read_exact(connection->fd, request->input, sizeof(*request->input) * input_length) != 0)
+        {
+            NC_FREE(request);
+            break;
+        }
+
+        request->connection = connection;
+        request->id = id;
+        request->arrival = server_now();
+
+        pthread_mutex_lock(&server->connections_mutex);
+        connection->references += 1;
+        pthread_mutex_unlock(&server->connections_mutex);
+
+        server_enqueue(server, request);
+    }
+
+    pthread_mutex_lock(&server->connections_mutex);
+
+    NCServerConnection** link = &server->connections;
+
+    while (*link != connection)
+    {
+        link = &(*link)->next;
+    }
+
+    *link = connection->next;
+    server->readers_amount -= 1;
+
+    pthread_cond_broadcast(&server->connections_closed);
+    pthread_mutex_unlock(&server->connections_mutex);
+
+    connection_release(connection);
+
+    return NULL;
+}
+
+static void* server_acceptor(void* argument)
+{
+    NCServer* server = argument;
+
+    for (;;)
+    {
+        int fd = accept(server->listen_fd, NULL, NULL);
+
+        pthread_mutex_lock(&server->queue_mutex);
+        int stopping = server->stopping;
+        pthread_mutex_unlock(&server->queue_mutex);
+
+        if (stopping)
+        {
+            if (fd >= 0) close(fd);
+            break;
+        }
+
+        if (fd < 0)
+        {
+            if (errno == EINTR || errno == ECONNABORTED) continue;
+            break;
+        }
+
+        NCServerConnection* connection = NC_MALLOC(sizeof(*connection), "server");
+        assert(connection != NULL);
+
+        connection->fd = fd;
+        connection->references = 1;
+        connection->server = server;
+        pthread_mutex_init(&connection->write_mutex, NULL);
+
+        pthread_mutex_lock(&server->connections_mutex);
+        connection->next = server->connections;
+        server->connections = connection;
+        server->readers_amount += 1;
+        pthread_mutex_unlock(&server->connections_mutex);
+
+        pthread_t reader;
+        pthread_attr_t attributes;
+
+        pthread_attr_init(&attributes);
+        pthread_attr_setdetachstate(&attributes, PTHREAD_CREATE_DETACHED);
+
+        if (pthread_create(&reader, &attributes, server_reader, connection) != 0)
+        {
+            shutdown(fd, SHUT_RDWR);
+            server_reader(connection);
+        }
+
+        pthread_attr_destroy(&attributes);
+    }
+
+    return NULL;
+}
+
+static size_t server_take_batch(NCServer* server, NCServerRequest** batch)
+{
+    size_t max_batch_size = server->config.max_batch_size;
+    unsigned long long max_wait = (unsigned long long)server->config.max_wait_microseconds * 1000ULL;
+
+    pthread_mutex_lock(&server->queue_mutex);
+
+    for (;;)
+    {
+        while (server->queue_length == 0 && !server->stopping)
+        {
+            pthread_cond_wait(&server->queue_filled, &server->queue_mutex);
+        }
+
+        if (server->queue_length == 0)
+        {
+            pthread_mutex_unlock(&server->queue_mutex);
+
+            return 0;
+        }
+
+        while (server->queue_length > 0 && server->queue_length < max_batch_size && !server->stopping)
+        {
+            unsigned long long now = server_now();
+            unsigned long long deadline = server->queue_head->arrival + max_wait;
+
+            if (now >= deadline) break;
+
+            struct timespec wake;
+            clock_gettime(CLOCK_REALTIME, &wake);
+
+            unsigned long long remaining = deadline - now + (unsigned long long)wake.tv_nsec;
+
+            wake.tv_sec += (time_t)(remaining / 1000000000ULL);
+            wake.tv_nsec = (long)(remaining % 1000000000ULL);
+
+            pthread_cond_timedwait(&server->queue_filled, &server->queue_mutex, &wake);
+        }
+
+        if (server->queue_length > 0) break;
+    }
+
+    size_t batch_size = 0;
+
+    while (server->queue_head != NULL && batch_size < max_batch_size)
+    {
+        batch[batch_size++] = server->queue_head;
+        server->queue_head = server->queue_head->next;
+    }
+
+    if (server->queue_head == NULL) server->queue_tail = NULL;
+
+    server->queue_length -= batch_size;
+
+    pthread_cond_broadcast(&server->queue_drained);
+    pthread_mutex_unlock(&server->queue_mutex);
+
+    return batch_size;
+}
+
+static void* server_worker(void* argument)
+{
+    NCServer* server = argument;
+    NCPerceptron model = server->model;
+
+    size_t layers_amount = perceptron_number_of_layers(model);
+    size_t max_batch_size = server->config.max_batch_size;
+    size_t input_length = layer_at_length(model.layers, 0);
+    size_t output_length = layer_at_length(model.layers, layers_amount - 1);
+
+    NCMatrix* buffers = NC_MALLOC(sizeof(*buffers) * layers_amount, "server");
+    NCMatrix* views = NC_MALLOC(sizeof(*views) * layers_amount, "server");
+    NCServerRequest** batch = NC_MALLOC(sizeof(*batch) * max_batch_size, "server");
+    unsigned long long* latencies = NC_MALLOC(sizeof(*latencies) * max_batch_size, "server");
+
+    assert(buffers != NULL && views != NULL && batch != NULL && latencies != NULL);
+
+    for (size_t i = 0; i < layers_amount; ++i)
+    {
+        buffers[i] = matrix_allocate(max_batch_size, layer_at_length(model.layers, i));
+    }
+
+    size_t batch_size;
+
+    while ((batch_size = server_take_batch(server, batch)) > 0)
+    {
+        for (size_t i = 0; i < layers_amount; ++i)
+        {
+            views[i] = buffers[i];
+            views[i].rows = batch_size;
+        }
+
+        for (size_t row = 0; row < batch_size; ++row)
+        {
+            memcpy(&MAT_AT(views[0], row, 0), batch[row]->input, sizeof(double) * input_length);
+        }
+
+        perceptron_forward_batch(model, views);
+
+        for (size_t row = 0; row < batch_size; ++row)
+        {
+            NCServerRequest* request = batch[row];
+            NCServerConnection* connection = request->connection;
+
+            pthread_mutex_lock(&connection->write_mutex);
+            write_message(connection->fd, request->id, &MAT_AT(views[layers_amount - 1], row, 0), (uint32_t)output_length);
+            pthread_mutex_unlock(&connection->write_mutex);
+
+            latencies[row] = (server_now() - request->arrival) / 1000ULL;
+
+            connection_release(connection);
+            NC_FREE(request);
+        }
+
+        pthread_mutex_lock(&server->stats_mutex);
+
+        server->requests += batch_size;
+        server->batches += 1;
+
+        for (size_t row = 0; row < batch_size; ++row)
+        {
+            histogram_record(&server->latency, latencies[row]);
+        }
+
+        pthread_mutex_unlock(&server->stats_mutex);
+    }
+
+    for (size_t i = 0; i < layers_amount; ++i)
+    {
+        matrix_delete(buffers[i]);
+    }
+
+    NC_FREE(buffers);
+    NC_FREE(views);
+    NC_FREE(batch);
+    NC_FREE(latencies);
+
+    return NULL;
+}
+
+NCServer* server_start(NCPerceptron model, NCServerConfig config)
+{
+    assert((config.socket_path != NULL) && "Server socket path must be set!");
+    assert((config.max_batch_size > 0) && "Server max batch size must be positive!");
+    assert((config.workers_amount > 0) && "Server must have at least one worker!");
+
+    struct sockaddr_un address;
+
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+
+    assert((strlen(config.socket_path) < sizeof(address.sun_path)) && "Server socket path is too long!");
+    strcpy(address.sun_path, config.socket_path);
+
+    int listen_fd = socket(AF_UNIX, SOCK_STREAM, 0);
+
+    if (listen_fd < 0)
+    {
+        perror("server_start: socket");
+        return NULL;
+    }
+
+    unlink(config.socket_path);
+
+    if (bind(listen_fd, (struct sockaddr*)&address, sizeof(address)) != 0 || listen(listen_fd, SERVER_LISTEN_BACKLOG) != 0)
+    {
+        perror("server_start: bind");
+        close(listen_fd);
+        return NULL;
+    }
+
+    if (config.max_queue_length < config.max_batch_size)
+    {
+        config.max_queue_length = config.max_batch_size * config.workers_amount * 4;
+    }
+
+    NCServer* server = NC_MALLOC(sizeof(*server), "server");
+    assert(server != NULL);
+
+    server->model = model;
+    server->config = config;
+    server->listen_fd = listen_fd;
+    server->stopping = 0;
+    server->started = server_now();
+
+    pthread_mutex_init(&server->queue_mutex, NULL);
+    pthread_cond_init(&server->queue_filled, NULL);
+    pthread_cond_init(&server->queue_drained, NULL);
+    server->queue_head = NULL;
+    server->queue_tail = NULL;
+    server->queue_length = 0;
+
+    pthread_mutex_init(&server->connections_mutex, NULL);
+    pthread_cond_init(&server->connections_closed, NULL);
+    server->connections = NULL;
+    server->readers_amount = 0;
+
+    pthread_mutex_init(&server->stats_mutex, NULL);
+    server->requests = 0;
+    server->batches = 0;
+    histogram_zero(&server->latency);
+
+    server->workers = NC_MALLOC(sizeof(*server->workers) * config.workers_amount, "server");
+    assert(server->workers != NULL);
+
+    for (size_t i = 0; i < config.workers_amount; ++i)
+    {
+        int created = pthread_create(&server->workers[i], NULL, server_worker, server);
+        assert((created == 0) && "Failed to create Server worker thread");
+    }
+
+    int created = pthread_create(&server->acceptor, NULL, server_acceptor, server);
+    assert((created == 0) && "Failed to create Server acceptor thread");
+
+    return server;
+}
+
+NCServerStats server_stats(NCServer* server)
+{
+    NCServerStats stats;
+
+    pthread_mutex_lock(&server->stats_mutex);
+
+    stats.requests = server->requests;
+    stats.batches = server->batches;
+    stats.seconds = (double)(server_now() - server->started) * 1e-9;
+    stats.throughput = stats.seconds > 0 ? (double)stats.requests / stats.seconds : 0;
+    stats.mean_batch_size = stats.batches > 0 ? (double)stats.requests / (double)stats.batches : 0;
+    stats.p50_microseconds = histogram_percentile(&server->latency, 0.50);
+    stats.p99_microseconds = histogram_percentile(&server->latency, 0.99);
+    stats.max_microseconds = (double)server->latency.maximum;
+
+    pthread_mutex_unlock(&server->stats_mutex);
+
+    return stats;
+}
+
+void server_print_stats(NCServerStats stats)
+{
+    printf("requests: %llu batches: %llu mean batch: %.2f\n", stats.requests, stats.batches, stats.mean_batch_size);
+    printf("throughput: %.1f req/s over %.3f s\n", stats.throughput, stats.seconds);
+    printf("latency us: p50 %.0f p99 %.0f max %.0f\n\n", stats.p50_microseconds, stats.p99_microseconds, stats.max_microseconds);
+}
+
+void server_stop(NCServer* server)
+{
+    pthread_mutex_lock(&server->queue_mutex);
+    server->stopping = 1;
+    pthread_mutex_unlock(&server->queue_mutex);
+
+    shutdown(server->listen_fd, SHUT_RDWR);
+    pthread_join(server->acceptor, NULL);
+
+    close(server->listen_fd);
+    unlink(server->config.socket_path);
+
+    pthread_mutex_lock(&server->connections_mutex);
+
+    for (NCServerConnection* connection = server->connections; connection != NULL; connection = connection->next)
+    {
+        shutdown(connection->fd, SHUT_RD);
+    }
+
+    while (server->readers_amount > 0)
+    {
+        pthread_cond_wait(&server->connections_closed, &server->connections_mutex);
+    }
+
+    pthread_mutex_unlock(&server->connections_mutex);
+
+    pthread_mutex_lock(&server->queue_mutex);
+    pthread_cond_broadcast(&server->queue_filled);
+    pthread_mutex_unlock(&server->queue_mutex);
+
+    for (size_t i = 0; i < server->config.workers_amount; ++i)
+    {
+        pthread_join(server->workers[i], NULL);
+    }
+
+    pthread_mutex_destroy(&server->queue_mutex);
+    pthread_cond_destroy(&server->queue_filled);
+    pthread_cond_destroy(&server->queue_drained);
+    pthread_mutex_destroy(&server->connections_mutex);
+    pthread_cond_destroy(&server->connections_closed);
+    pthread_mutex_destroy(&server->stats_mutex);
+
+    NC_FREE(server->workers);
+    NC_FREE(server);
+}
+
+static unsigned long long load_random(unsigned long long* state)
+{
+    *state ^= *state << 13;
+    *state ^= *state >> 7;
+    *state ^= *state << 17;
+
+    return *state;
+}
+
+static void* load_client(void* argument)
+{
+    NCLoadClient* client = argument;
+    NCLoadConfig config = client->config;
+
+    struct sockaddr_un address;
+
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    strncpy(address.sun_path, config.socket_path, sizeof(address.sun_path) - 1);
+
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+
+    if (fd < 0 || connect(fd, (struct sockaddr*)&address, sizeof(address)) != 0)
+    {
+        perror("server_load_generate: connect");
+        if (fd >= 0) close(fd);
+        return NULL;
+    }
+
+    double* input = NC_MALLOC(sizeof(*input) * config.input_length, "server");
+    double* output = NC_MALLOC(sizeof(*output) * config.output_length, "server");
+    unsigned long long* sent_at = NC_MALLOC(sizeof(*sent_at) * config.requests_per_client, "server");
+
+    assert(input != NULL && output != NULL && sent_at != NULL);
+
+    for (size_t i = 0; i < config.input_length; ++i)
+    {
+        input[i] = 2 * (double)(load_random(&client->seed) >> 11) / (double)(1ULL << 53) - 1;
+    }
+
+    size_t sent = 0;
+
+    while (sent < config.requests_per_client && sent < config.in_flight_per_client)
+    {
+        sent_at[sent] = server_now();
+        if (write_message(fd, sent, input, (uint32_t)config.input_length) != 0) break;
+        ++sent;
+    }
+
+    while (client->received < sent)
+    {
+        uint64_t id;
+        uint32_t length;
+
+        if (read_header(fd, &id, &length) != 0 || length != config.output_length || id >= sent) break;
+        if (read_exact(fd, output, sizeof(*output) * length) != 0) break;
+
+        histogram_record(&client->latency, (server_now() - sent_at[id]) / 1000ULL);
+        client->received += 1;
+
+        if (sent < config.requests_per_client)
+        {
+            sent_at[sent] = server_now();
+            if (write_message(fd, sent, input, (uint32_t)config.input_length) != 0) break;
+            ++sent;
+        }
+    }
+
+    close(fd);
+
+    NC_FREE(input);
+    NC_FREE(output);
+    NC_FREE(sent_at);
+
+    return NULL;
+}
+
+NCServerStats server_load_generate(NCLoadConfig config)
+{
+    assert((config.clients_amount > 0) && "Load generator needs at least one client!");
+    assert((config.in_flight_per_client > 0) && "Load generator needs at least one request in flight!");
+
+    NCLoadClient* clients = NC_MALLOC(sizeof(*clients) * config.clients_amount, "server");
+    pthread_t* threads = NC_MALLOC(sizeof(*threads) * config.clients_amount, "server");
+
+    assert(clients != NULL && threads != NULL);
+
+    unsigned long long started = server_now();
+
+    for (size_t i = 0; i < config.clients_amount; ++i)
+    {
+        clients[i].config = config;
+        clients[i].seed = 0x9E3779B97F4A7C15ULL * (i + 1);
+        clients[i].received = 0;
+        histogram_zero(&clients[i].latency);
+
+        int created = pthread_create(&threads[i], NULL, load_client, &clients[i]);
+        assert((created == 0) && "Failed to create load generator client thread");
+    }
+
+    NCLatencyHistogram latency;
+    histogram_zero(&latency);
+
+    NCServerStats stats;
+    stats.requests = 0;
+    stats.batches = 0;
+    stats.mean_batch_size = 0;
+
+    for (size_t i = 0; i < config.clients_amount; ++i)
+    {
+        pthread_join(threads[i], NULL);
+
+        stats.requests += clients[i].received;
+        histogram_merge(&latency, &clients[i].latency);
+    }
+
+    stats.seconds = (double)(server_now() - started) * 1e-9;
+    stats.throughput = stats.seconds > 0 ? (double)stats.requests / stats.seconds : 0;
+    stats.p50_microseconds = histogram_percentile(&latency, 0.50);
+    stats.p99_microseconds = histogram_percentile(&latency, 0.99);
+    stats.max_microseconds = (double)latency.maximum;
+
+    NC_FREE(clients);
+    NC_FREE(threads);
+
+    return stats;
+}
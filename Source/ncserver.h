@@ -0,0 +1,104 @@
+#ifndef NCSERVER_H
+#define NCSERVER_H
+
+#include <pthread.h>
+#include <stdint.h>
+
+#include "numc.h"
+
+/*
+ * Dynamic-batching inference service for NCPerceptron over a local Unix domain socket.
+ *
+ * Wire format ( native byte order, both directions ):
+ *     uint64 request id | uint32 amount of doubles | doubles
+ * A request carries one input row, the response carries the output row for the same id.
+ * Responses of one connection may come back out of order, clients match them by id.
+ */
+
+#define SERVER_HISTOGRAM_SUB_BUCKETS 8
+#define SERVER_HISTOGRAM_BUCKETS (SERVER_HISTOGRAM_SUB_BUCKETS * 40)
+
+typedef struct
+{
+    unsigned long long count;
+    unsigned long long maximum;
+    unsigned long long buckets[SERVER_HISTOGRAM_BUCKETS];
+} NCLatencyHistogram; // NumC Latency histogram structure that contain: log-linear buckets of latencies in microseconds
+
+typedef struct
+{
+    const char* socket_path;
+    size_t max_batch_size;
+    size_t max_wait_microseconds;
+    size_t workers_amount;
+    size_t max_queue_length;
+} NCServerConfig; // NumC Server config structure that contain: socket path, batching bounds, worker pool size and request queue bound
+
+typedef struct
+{
+    unsigned long long requests;
+    unsigned long long batches;
+    double seconds;
+    double throughput;
+    double mean_batch_size;
+    double p50_microseconds;
+    double p99_microseconds;
+    double max_microseconds;
+} NCServerStats; // NumC Server stats structure that contain: counters, throughput in requests per second and latency percentiles
+
+typedef struct
+{
+    const char* socket_path;
+    size_t clients_amount;
+    size_t requests_per_client;
+    size_t in_flight_per_client;
+    size_t input_length;
+    size_t output_length;
+} NCLoadConfig; // NumC Load config structure that contain: target socket, amount of clients, requests and pipelined requests per client, row lengths
+
+typedef struct NCServerRequest NCServerRequest;
+typedef struct NCServerConnection NCServerConnection;
+
+typedef struct
+{
+    NCPerceptron model;
+    NCServerConfig config;
+
+    int listen_fd;
+    int stopping;
+    unsigned long long started;
+
+    pthread_t acceptor;
+    pthread_t* workers;
+
+    pthread_mutex_t queue_mutex;
+    pthread_cond_t queue_filled;
+    pthread_cond_t queue_drained;
+    NCServerRequest* queue_head;
+    NCServerRequest* queue_tail;
+    size_t queue_length;
+
+    pthread_mutex_t connections_mutex;
+    pthread_cond_t connections_closed;
+    NCServerConnection* connections;
+    size_t readers_amount;
+
+    pthread_mutex_t stats_mutex;
+    unsigned long long requests;
+    unsigned long long batches;
+    NCLatencyHistogram latency;
+} NCServer; // NumC Server structure that contain: served model, config, listening socket, request queue, open connections and stats
+
+void histogram_zero(NCLatencyHistogram* histogram); // clears all buckets
+void histogram_record(NCLatencyHistogram* histogram, unsigned long long microseconds); // adds one latency sample
+void histogram_merge(NCLatencyHistogram* destination, const NCLatencyHistogram* source); // adds all samples of source into destination
+double histogram_percentile(const NCLatencyHistogram* histogram, double percentile); // returns an upper bound of the given percentile in microseconds, percentile in [0, 1]
+
+NCServer* server_start(NCPerceptron model, NCServerConfig config); // binds the socket and starts acceptor and worker threads, the model must outlive the server
+NCServerStats server_stats(NCServer* server); // returns a snapshot of counters and latency percentiles
+void server_print_stats(NCServerStats stats); // prints server or load generator stats
+void server_stop(NCServer* server); // closes all connections, answers queued requests, joins all threads and frees the server
+
+NCServerStats server_load_generate(NCLoadConfig config); // runs closed-loop clients against a server and returns client-side throughput and latency
+
+#endif // NCSERVER_H
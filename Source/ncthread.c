@@ -0,0 +1,203 @@
+#include "ncthread.h"
+#include "ncmemory.h"
+
+#include <assert.h>
+#include <malloc.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+static _Thread_local int inside_pool = 0;
+
+static pthread_once_t default_pool_once = PTHREAD_ONCE_INIT;
+static NCThreadPool* default_pool = NULL;
+
+// takes tasks until none are left, the pool mutex must be held and is held again on return
+static void thread_pool_drain(NCThreadPool* pool)
+{
+    while (pool->next_task < pool->tasks_amount)
+    {
+        size_t index = pool->next_task++;
+
+        pthread_mutex_unlock(&pool->mutex);
+        pool->task(pool->context, index);
+        pthread_mutex_lock(&pool->mutex);
+
+        if (--pool->remaining_tasks == 0)
+        {
+            pthread_cond_broadcast(&pool->work_done);
+        }
+    }
+}
+
+static void* thread_pool_worker(void* argument)
+{
+    NCThreadPool* pool = argument;
+    unsigned long long seen = 0;
+
+    inside_pool = 1;
+
+    pthread_mutex_lock(&pool->mutex);
+
+    for (;;)
+    {
+        while (pool->generation == seen && !pool->stopping)
+        {
+            pthread_cond_wait(&pool->work_ready, &pool->mutex);
+        }
+
+        if (pool->stopping)
+        {
+            break;
+        }
+
+        seen = pool->generation;
+        pool->active_workers += 1;
+
+        thread_pool_drain(pool);
+
+        if (--pool->active_workers == 0)
+        {
+            pthread_cond_broadcast(&pool->work_done);
+        }
+    }
+
+    pthread_mutex_unlock(&pool->mutex);
+
+    return NULL;
+}
+
+// starts the workers of a pool whose storage the caller has already allocated
+static void thread_pool_start(NCThreadPool* pool, size_t threads_amount)
+{
+    pool->threads_amount = threads_amount;
+
+    pthread_mutex_init(&pool->run_mutex, NULL);
+    pthread_mutex_init(&pool->mutex, NULL);
+    pthread_cond_init(&pool->work_ready, NULL);
+    pthread_cond_init(&pool->work_done, NULL);
+
+    pool->task = NULL;
+    pool->context = NULL;
+    pool->tasks_amount = 0;
+    pool->next_task = 0;
+    pool->remaining_tasks = 0;
+    pool->active_workers = 0;
+    pool->generation = 0;
+    pool->stopping = 0;
+
+    for (size_t i = 1; i < threads_amount; ++i)
+    {
+        int created = pthread_create(&pool->threads[i], NULL, thread_pool_worker, pool);
+        assert((created == 0) && "Failed to create thread pool worker");
+    }
+}
+
+NCThreadPool* thread_pool_allocate(size_t threads_amount)
+{
+    assert((threads_amount > 0) && "Thread pool needs at least one thread!");
+
+    NCThreadPool* pool = NC_MALLOC(sizeof(*pool), "thread");
+    assert(pool != NULL);
+
+    pool->threads = NC_MALLOC(sizeof(*pool->threads) * threads_amount, "thread");
+    assert(pool->threads != NULL);
+
+    thread_pool_start(pool, threads_amount);
+
+    return pool;
+}
+
+void thread_pool_run(NCThreadPool* pool, task_type task, void* context, size_t tasks_amount)
+{
+    if (inside_pool || pool->threads_amount == 1 || tasks_amount == 1)
+    {
+        for (size_t i = 0; i < tasks_amount; ++i)
+        {
+            task(context, i);
+        }
+
+        return;
+    }
+
+    pthread_mutex_lock(&pool->run_mutex);
+    pthread_mutex_lock(&pool->mutex);
+
+    // workers still leaving the previous run would otherwise pick up this one as already seen
+    while (pool->active_workers > 0)
+    {
+        pthread_cond_wait(&pool->work_done, &pool->mutex);
+    }
+
+    pool->task = task;
+    pool->context = context;
+    pool->tasks_amount = tasks_amount;
+    pool->next_task = 0;
+    pool->remaining_tasks = tasks_amount;
+    pool->generation += 1;
+
+    pthread_cond_broadcast(&pool->work_ready);
+
+    inside_pool = 1;
+    thread_pool_drain(pool);
+    inside_pool = 0;
+
+    while (pool->remaining_tasks > 0)
+    {
+        pthread_cond_wait(&pool->work_done, &pool->mutex);
+    }
+
+    pthread_mutex_unlock(&pool->mutex);
+    pthread_mutex_unlock(&pool->run_mutex);
+}
+
+void thread_pool_delete(NCThreadPool* pool)
+{
+    pthread_mutex_lock(&pool->mutex);
+    pool->stopping = 1;
+    pthread_cond_broadcast(&pool->work_ready);
+    pthread_mutex_unlock(&pool->mutex);
+
+    for (size_t i = 1; i < pool->threads_amount; ++i)
+    {
+        pthread_join(pool->threads[i], NULL);
+    }
+
+    pthread_mutex_destroy(&pool->run_mutex);
+    pthread_mutex_destroy(&pool->mutex);
+    pthread_cond_destroy(&pool->work_ready);
+    pthread_cond_destroy(&pool->work_done);
+
+    NC_FREE(pool->threads);
+    NC_FREE(pool);
+}
+
+size_t thread_hardware_concurrency(void)
+{
+    long processors = sysconf(_SC_NPROCESSORS_ONLN);
+
+    return processors > 0 ? (size_t)processors : 1;
+}
+
+static void thread_pool_default_create(void)
+{
+    const char* requested = getenv("NUMC_THREADS");
+    size_t threads_amount = requested != NULL ? strtoul(requested, NULL, 10) : 0;
+
+    threads_amount = threads_amount > 0 ? threads_amount : thread_hardware_concurrency();
+
+    // the shared pool lives as long as the process, so it stays out of the tracked allocations and their leak report
+    default_pool = malloc(sizeof(*default_pool));
+    assert(default_pool != NULL);
+
+    default_pool->threads = malloc(sizeof(*default_pool->threads) * threads_amount);
+    assert(default_pool->threads != NULL);
+
+    thread_pool_start(default_pool, threads_amount);
+}
+
+NCThreadPool* thread_pool_default(void)
+{
+    pthread_once(&default_pool_once, thread_pool_default_create);
+
+    return default_pool;
+}
@@ -0,0 +1,41 @@
+#ifndef NCTHREAD_H
+#define NCTHREAD_H
+
+#include <pthread.h>
+#include <stddef.h>
+
+/*
+ * Fork-join thread pool: thread_pool_run hands out task indices to the workers and the
+ * calling thread, and returns once every task finished. A run issued from inside a task
+ * executes inline, so library kernels may use the default pool from any context.
+ */
+
+typedef void (*task_type)(void* context, size_t index);
+
+typedef struct
+{
+    size_t threads_amount;
+    pthread_t* threads;
+
+    pthread_mutex_t run_mutex;
+    pthread_mutex_t mutex;
+    pthread_cond_t work_ready;
+    pthread_cond_t work_done;
+
+    task_type task;
+    void* context;
+    size_t tasks_amount;
+    size_t next_task;
+    size_t remaining_tasks;
+    size_t active_workers;
+    unsigned long long generation;
+    int stopping;
+} NCThreadPool; // NumC Thread pool structure that contain: amount of threads including the caller, workers and the current parallel-for
+
+NCThreadPool* thread_pool_allocate(size_t threads_amount); // starts a pool of threads_amount threads, the calling thread counts as one of them
+void thread_pool_run(NCThreadPool* pool, task_type task, void* context, size_t tasks_amount); // runs task(context, i) for every i in [0, tasks_amount) and waits for all of them
+void thread_pool_delete(NCThreadPool* pool); // joins all workers and frees the pool
+NCThreadPool* thread_pool_default(void); // returns a shared pool sized by NUMC_THREADS or the amount of online processors
+size_t thread_hardware_concurrency(void); // returns the amount of online processors
+
+#endif // NCTHREAD_H
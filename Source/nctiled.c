@@ -0,0 +1,858 @@
+#include "nctiled.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define TILED_MAGIC "NCTILED"
+#define TILED_HEADER_BYTES 64
+
+typedef void (*tiled_binary_type)(NCMatrix destination, NCMatrix first, NCMatrix second);
+
+typedef struct
+{
+    char magic[8];
+    uint64_t rows;
+    uint64_t columns;
+    uint64_t tile_size;
+} NCTiledHeader; // NumC Tiled header structure that contain: magic, shape and tile size as stored at the start of the file
+
+typedef struct
+{
+    size_t rows;
+    size_t columns;
+    size_t inner;
+    size_t stride;
+    size_t tasks_amount;
+    const double* first;
+    const double* second;
+    double* destination;
+} NCTiledDotContext; // NumC Tiled dot context structure that contain: valid sizes of one tile product, tile stride and tiles
+
+static size_t tiled_tile_numbers(const NCTiledMatrix* matrix)
+{
+    return matrix->tile_size * matrix->tile_size;
+}
+
+static int tiled_transfer(NCTiledMatrix* matrix, size_t tile, double* numbers, int write)
+{
+    size_t bytes = sizeof(*numbers) * tiled_tile_numbers(matrix);
+    off_t offset = (off_t)TILED_HEADER_BYTES + (off_t)tile * (off_t)bytes;
+    char* cursor = (char*)numbers;
+
+    while (bytes > 0)
+    {
+        ssize_t moved = write ? pwrite(matrix->file, cursor, bytes, offset) : pread(matrix->file, cursor, bytes, offset);
+
+        if (moved < 0 && errno == EINTR)
+        {
+            continue;
+        }
+
+        if (moved < 0)
+        {
+            perror(write ? "tiled_matrix: pwrite" : "tiled_matrix: pread");
+            return -1;
+        }
+
+        if (moved == 0)
+        {
+            fprintf(stderr, "tiled_matrix: tile %zu is past the end of the file\n", tile);
+            return -1;
+        }
+
+        cursor += moved;
+        offset += moved;
+        bytes -= (size_t)moved;
+    }
+
+    return 0;
+}
+
+// the mutex must be held
+static NCTiledSlot* tiled_find(NCTiledMatrix* matrix, size_t tile)
+{
+    for (size_t i = 0; i < matrix->slots_amount; ++i)
+    {
+        NCTiledSlot* slot = &matrix->slots[i];
+
+        if (slot->state != SLOT_EMPTY && slot->tile == tile)
+        {
+            return slot;
+        }
+    }
+
+    return NULL;
+}
+
+// a slot being written back still owns the old tile on disk, the mutex must be held
+static int tiled_writing_back(NCTiledMatrix* matrix, size_t tile)
+{
+    for (size_t i = 0; i < matrix->slots_amount; ++i)
+    {
+        NCTiledSlot* slot = &matrix->slots[i];
+
+        if (slot->state == SLOT_LOADING && slot->writing && slot->previous == tile)
+        {
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+// an empty slot, or the least recently used unpinned tile, or NULL when every slot is busy; the mutex must be held
+static NCTiledSlot* tiled_victim(NCTiledMatrix* matrix)
+{
+    NCTiledSlot* victim = NULL;
+
+    for (size_t i = 0; i < matrix->slots_amount; ++i)
+    {
+        NCTiledSlot* slot = &matrix->slots[i];
+
+        if (slot->state == SLOT_EMPTY)
+        {
+            victim = slot;
+            break;
+        }
+
+        if (slot->state == SLOT_READY && slot->pins == 0 && (victim == NULL || slot->used < victim->used))
+        {
+            victim = slot;
+        }
+    }
+
+    if (victim != NULL && victim->numbers == NULL)
+    {
+        victim->numbers = NC_ALIGNED_ALLOC(64, sizeof(*victim->numbers) * tiled_tile_numbers(matrix), "tiled");
+        assert(victim->numbers != NULL);
+    }
+
+    return victim;
+}
+
+// puts a tile into a victim slot, writing its old tile back first; drops the mutex during I/O and holds it again on return
+// returns -1 when the I/O fails, the slot then keeps its old tile if that could not be written back or is emptied otherwise
+static int tiled_load(NCTiledMatrix* matrix, NCTiledSlot* slot, size_t tile, int read, size_t pins)
+{
+    slot->writing = slot->state == SLOT_READY && slot->dirty;
+    slot->previous = slot->tile;
+    slot->state = SLOT_LOADING;
+    slot->tile = tile;
+    slot->dirty = 0;
+    slot->pins = 0;
+
+    pthread_mutex_unlock(&matrix->mutex);
+
+    int written = !slot->writing || tiled_transfer(matrix, slot->previous, slot->numbers, 1) == 0;
+    int loaded = written && (!read || tiled_transfer(matrix, tile, slot->numbers, 0) == 0);
+
+    if (loaded && !read)
+    {
+        memset(slot->numbers, 0, sizeof(*slot->numbers) * tiled_tile_numbers(matrix));
+    }
+
+    pthread_mutex_lock(&matrix->mutex);
+
+    pthread_cond_broadcast(&matrix->changed);
+
+    if (!written)
+    {
+        slot->tile = slot->previous;
+        slot->dirty = 1;
+        slot->writing = 0;
+        slot->state = SLOT_READY;
+
+        return -1;
+    }
+
+    matrix->stats.writes += slot->writing;
+    slot->writing = 0;
+
+    if (!loaded)
+    {
+        slot->state = SLOT_EMPTY;
+
+        return -1;
+    }
+
+    matrix->stats.loads += read;
+
+    slot->state = SLOT_READY;
+    slot->pins = pins;
+    slot->used = ++matrix->clock;
+
+    return 0;
+}
+
+static void* tiled_prefetcher(void* argument)
+{
+    NCTiledMatrix* matrix = argument;
+
+    pthread_mutex_lock(&matrix->mutex);
+
+    for (;;)
+    {
+        while (!matrix->stopping && matrix->queue_length == 0)
+        {
+            pthread_cond_wait(&matrix->requested, &matrix->mutex);
+        }
+
+        if (matrix->stopping)
+        {
+            break;
+        }
+
+        size_t tile = matrix->queue[matrix->queue_first];
+
+        matrix->queue_first = (matrix->queue_first + 1) % TILED_PREFETCH_QUEUE;
+        matrix->queue_length -= 1;
+
+        if (tiled_find(matrix, tile) != NULL || tiled_writing_back(matrix, tile))
+        {
+            continue;
+        }
+
+        NCTiledSlot* victim = tiled_victim(matrix);
+
+        if (victim == NULL)
+        {
+            continue;
+        }
+
+        // a failed prefetch is left to the acquire that needs the tile
+        if (tiled_load(matrix, victim, tile, 1, 0) == 0)
+        {
+            matrix->stats.prefetches += 1;
+        }
+    }
+
+    pthread_mutex_unlock(&matrix->mutex);
+
+    return NULL;
+}
+
+// returns the file length needed for a shape, 0 when the shape is empty or the length does not fit
+static off_t tiled_file_length(size_t rows, size_t columns, size_t tile_size)
+{
+    if (rows == 0 || columns == 0 || tile_size == 0 || tile_size > ((size_t)1 << 20))
+    {
+        return 0;
+    }
+
+    size_t tiles = ((rows + tile_size - 1) / tile_size) * ((columns + tile_size - 1) / tile_size);
+    size_t tile_bytes = tile_size * tile_size * sizeof(double);
+
+    if (tiles > ((size_t)INT64_MAX - TILED_HEADER_BYTES) / tile_bytes)
+    {
+        return 0;
+    }
+
+    return (off_t)TILED_HEADER_BYTES + (off_t)(tiles * tile_bytes);
+}
+
+static NCTiledMatrix* tiled_matrix_start(int file, size_t rows, size_t columns, size_t tile_size, size_t budget)
+{
+    NCTiledMatrix* matrix = NC_MALLOC(sizeof(*matrix), "tiled");
+    assert(matrix != NULL);
+
+    matrix->rows = rows;
+    matrix->columns = columns;
+    matrix->tile_size = tile_size;
+    matrix->tiles_down = (rows + tile_size - 1) / tile_size;
+    matrix->tiles_across = (columns + tile_size - 1) / tile_size;
+    matrix->file = file;
+
+    matrix->slots_amount = budget / (sizeof(double) * tiled_tile_numbers(matrix));
+
+    assert((matrix->slots_amount >= TILED_MINIMUM_SLOTS) && "Tiled matrix budget must hold at least TILED_MINIMUM_SLOTS tiles!");
+
+    matrix->slots = NC_CALLOC(matrix->slots_amount, sizeof(*matrix->slots), "tiled");
+    assert(matrix->slots != NULL);
+
+    matrix->clock = 0;
+    matrix->queue_first = 0;
+    matrix->queue_length = 0;
+    matrix->stopping = 0;
+    memset(&matrix->stats, 0, sizeof(matrix->stats));
+
+    pthread_mutex_init(&matrix->mutex, NULL);
+    pthread_cond_init(&matrix->changed, NULL);
+    pthread_cond_init(&matrix->requested, NULL);
+
+    int created = pthread_create(&matrix->prefetcher, NULL, tiled_prefetcher, matrix);
+    assert((created == 0) && "Failed to create tiled matrix prefetch thread");
+
+    return matrix;
+}
+
+NCTiledMatrix* tiled_matrix_create(const char* path, size_t rows, size_t columns, size_t tile_size, size_t budget)
+{
+    assert((rows > 0 && columns > 0 && tile_size > 0) && "Tiled matrix dimensions must be positive!");
+
+    int file = open(path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+
+    if (file < 0)
+    {
+        perror("tiled_matrix_create: open");
+        return NULL;
+    }
+
+    NCTiledHeader header;
+    char block[TILED_HEADER_BYTES] = { 0 };
+
+    memcpy(header.magic, TILED_MAGIC, sizeof(header.magic));
+    header.rows = rows;
+    header.columns = columns;
+    header.tile_size = tile_size;
+    memcpy(block, &header, sizeof(header));
+
+    off_t length = tiled_file_length(rows, columns, tile_size);
+
+    assert((length > 0) && "Tiled matrix file would be too large!");
+
+    // the tile area is left as a hole, which reads back as zeros
+    if (pwrite(file, block, sizeof(block), 0) != (ssize_t)sizeof(block) || ftruncate(file, length) != 0)
+    {
+        perror("tiled_matrix_create: write");
+        close(file);
+        return NULL;
+    }
+
+    return tiled_matrix_start(file, rows, columns, tile_size, budget);
+}
+
+NCTiledMatrix* tiled_matrix_open(const char* path, size_t budget)
+{
+    int file = open(path, O_RDWR);
+
+    if (file < 0)
+    {
+        perror("tiled_matrix_open: open");
+        return NULL;
+    }
+
+    NCTiledHeader header;
+
+    if (pread(file, &header, sizeof(header), 0) != (ssize_t)sizeof(header) || memcmp(header.magic, TILED_MAGIC, sizeof(header.magic)) != 0)
+    {
+        fprintf(stderr, "tiled_matrix_open: %s is not a tiled matrix\n", path);
+        close(file);
+        return NULL;
+    }
+
+    struct stat status;
+    off_t length = header.rows <= SIZE_MAX && header.columns <= SIZE_MAX && header.tile_size <= SIZE_MAX ?
+                   tiled_file_length((size_t)header.rows, (size_t)header.columns, (size_t)header.tile_size) : 0;
+
+    if (length == 0)
+    {
+        fprintf(stderr, "tiled_matrix_open: %s has an invalid shape\n", path);
+        close(file);
+        return NULL;
+    }
+
+    if (fstat(file, &status) != 0 || status.st_size < length)
+    {
+        fprintf(stderr, "tiled_matrix_open: %s is shorter than its tiles\n", path);
+        close(file);
+        return NULL;
+    }
+
+    return tiled_matrix_start(file, (size_t)header.rows, (size_t)header.columns, (size_t)header.tile_size, budget);
+}
+
+NCTiledMatrix* tiled_matrix_from_matrix(const char* path, NCMatrix matrix, size_t tile_size, size_t budget)
+{
+    NCTiledMatrix* tiled = tiled_matrix_create(path, matrix.rows, matrix.columns, tile_size, budget);
+
+    if (tiled == NULL)
+    {
+        return NULL;
+    }
+
+    for (size_t i = 0; i < tiled->tiles_down; ++i)
+    {
+        for (size_t j = 0; j < tiled->tiles_across; ++j)
+        {
+            NCMatrix tile = tiled_matrix_acquire(tiled, i, j, TILED_OVERWRITE);
+            size_t rows = tiled_matrix_tile_rows(tiled, i);
+            size_t columns = tiled_matrix_tile_columns(tiled, j);
+
+            for (size_t row = 0; row < rows; ++row)
+            {
+                memcpy(&MAT_AT(tile, row, 0), &MAT_AT(matrix, i * tile_size + row, j * tile_size), sizeof(double) * columns);
+            }
+
+            tiled_matrix_release(tiled, i, j);
+        }
+    }
+
+    return tiled;
+}
+
+void tiled_matrix_to_matrix(NCMatrix destination, NCTiledMatrix* matrix)
+{
+    assert((destination.rows == matrix->rows && destination.columns == matrix->columns) && "Destination dimensions must be correct!");
+
+    size_t tiles = matrix->tiles_down * matrix->tiles_across;
+
+    for (size_t t = 0; t < tiles; ++t)
+    {
+        size_t i = t / matrix->tiles_across;
+        size_t j = t % matrix->tiles_across;
+
+        if (t + 1 < tiles)
+        {
+            tiled_matrix_prefetch(matrix, (t + 1) / matrix->tiles_across, (t + 1) % matrix->tiles_across);
+        }
+
+        NCMatrix tile = tiled_matrix_acquire(matrix, i, j, TILED_READ);
+        size_t rows = tiled_matrix_tile_rows(matrix, i);
+        size_t columns = tiled_matrix_tile_columns(matrix, j);
+
+        for (size_t row = 0; row < rows; ++row)
+        {
+            memcpy(&MAT_AT(destination, i * matrix->tile_size + row, j * matrix->tile_size), &MAT_AT(tile, row, 0), sizeof(double) * columns);
+        }
+
+        tiled_matrix_release(matrix, i, j);
+    }
+}
+
+int tiled_matrix_close(NCTiledMatrix* matrix)
+{
+    pthread_mutex_lock(&matrix->mutex);
+    matrix->stopping = 1;
+    pthread_cond_signal(&matrix->requested);
+    pthread_mutex_unlock(&matrix->mutex);
+
+    pthread_join(matrix->prefetcher, NULL);
+
+    int result = tiled_matrix_flush(matrix);
+
+    if (close(matrix->file) != 0)
+    {
+        perror("tiled_matrix_close: close");
+        result = -1;
+    }
+
+    for (size_t i = 0; i < matrix->slots_amount; ++i)
+    {
+        NC_FREE(matrix->slots[i].numbers);
+    }
+
+    pthread_mutex_destroy(&matrix->mutex);
+    pthread_cond_destroy(&matrix->changed);
+    pthread_cond_destroy(&matrix->requested);
+
+    NC_FREE(matrix->slots);
+    NC_FREE(matrix);
+
+    return result;
+}
+
+NCMatrix tiled_matrix_acquire(NCTiledMatrix* matrix, size_t tile_row, size_t tile_column, NCTiledAccess access)
+{
+    assert((tile_row < matrix->tiles_down && tile_column < matrix->tiles_across) && "Tile position is out of the matrix!");
+
+    size_t tile = tile_row * matrix->tiles_across + tile_column;
+    NCTiledSlot* slot = NULL;
+    int stalled = 0;
+
+    pthread_mutex_lock(&matrix->mutex);
+
+    for (;;)
+    {
+        slot = tiled_find(matrix, tile);
+
+        if (slot != NULL && slot->state == SLOT_READY)
+        {
+            slot->pins += 1;
+            slot->used = ++matrix->clock;
+            break;
+        }
+
+        NCTiledSlot* victim = slot == NULL && !tiled_writing_back(matrix, tile) ? tiled_victim(matrix) : NULL;
+
+        stalled = 1;
+
+        if (victim == NULL)
+        {
+            pthread_cond_wait(&matrix->changed, &matrix->mutex);
+            continue;
+        }
+
+        if (tiled_load(matrix, victim, tile, access != TILED_OVERWRITE, 1) != 0)
+        {
+            fprintf(stderr, "tiled_matrix_acquire: cannot load tile ( %zu, %zu )\n", tile_row, tile_column);
+            abort();
+        }
+
+        slot = victim;
+        break;
+    }
+
+    if (access != TILED_READ)
+    {
+        slot->dirty = 1;
+    }
+
+    matrix->stats.stalls += stalled;
+
+    pthread_mutex_unlock(&matrix->mutex);
+
+    NCMatrix view = { matrix->tile_size, matrix->tile_size, slot->numbers };
+
+    return view;
+}
+
+void tiled_matrix_release(NCTiledMatrix* matrix, size_t tile_row, size_t tile_column)
+{
+    pthread_mutex_lock(&matrix->mutex);
+
+    NCTiledSlot* slot = tiled_find(matrix, tile_row * matrix->tiles_across + tile_column);
+
+    assert((slot != NULL && slot->state == SLOT_READY && slot->pins > 0) && "Released tile was not acquired!");
+
+    slot->pins -= 1;
+    slot->used = ++matrix->clock;
+
+    if (slot->pins == 0)
+    {
+        pthread_cond_broadcast(&matrix->changed);
+    }
+
+    pthread_mutex_unlock(&matrix->mutex);
+}
+
+void tiled_matrix_prefetch(NCTiledMatrix* matrix, size_t tile_row, size_t tile_column)
+{
+    if (tile_row >= matrix->tiles_down || tile_column >= matrix->tiles_across)
+    {
+        return;
+    }
+
+    size_t tile = tile_row * matrix->tiles_across + tile_column;
+
+    pthread_mutex_lock(&matrix->mutex);
+
+    if (matrix->queue_length < TILED_PREFETCH_QUEUE && tiled_find(matrix, tile) == NULL)
+    {
+        matrix->queue[(matrix->queue_first + matrix->queue_length) % TILED_PREFETCH_QUEUE] = tile;
+        matrix->queue_length += 1;
+
+        pthread_cond_signal(&matrix->requested);
+    }
+
+    pthread_mutex_unlock(&matrix->mutex);
+}
+
+int tiled_matrix_flush(NCTiledMatrix* matrix)
+{
+    int result = 0;
+
+    pthread_mutex_lock(&matrix->mutex);
+
+    for (size_t i = 0; i < matrix->slots_amount; ++i)
+    {
+        NCTiledSlot* slot = &matrix->slots[i];
+
+        if (slot->state == SLOT_READY && slot->dirty)
+        {
+            if (tiled_transfer(matrix, slot->tile, slot->numbers, 1) != 0)
+            {
+                result = -1;
+                continue;
+            }
+
+            slot->dirty = 0;
+            matrix->stats.writes += 1;
+        }
+    }
+
+    pthread_mutex_unlock(&matrix->mutex);
+
+    return result;
+}
+
+size_t tiled_matrix_tile_rows(NCTiledMatrix* matrix, size_t tile_row)
+{
+    size_t first = tile_row * matrix->tile_size;
+
+    return matrix->rows - first < matrix->tile_size ? matrix->rows - first : matrix->tile_size;
+}
+
+size_t tiled_matrix_tile_columns(NCTiledMatrix* matrix, size_t tile_column)
+{
+    size_t first = tile_column * matrix->tile_size;
+
+    return matrix->columns - first < matrix->tile_size ? matrix->columns - first : matrix->tile_size;
+}
+
+double tiled_matrix_at(NCTiledMatrix* matrix, size_t row, size_t column)
+{
+    assert((row < matrix->rows && column < matrix->columns) && "Position is out of the matrix!");
+
+    size_t size = matrix->tile_size;
+    NCMatrix tile = tiled_matrix_acquire(matrix, row / size, column / size, TILED_READ);
+    double value = MAT_AT(tile, row % size, column % size);
+
+    tiled_matrix_release(matrix, row / size, column / size);
+
+    return value;
+}
+
+NCTiledStats tiled_matrix_stats(NCTiledMatrix* matrix)
+{
+    pthread_mutex_lock(&matrix->mutex);
+
+    NCTiledStats stats = matrix->stats;
+
+    pthread_mutex_unlock(&matrix->mutex);
+
+    return stats;
+}
+
+static void tiled_dot_task(void* argument, size_t task)
+{
+    NCTiledDotContext* context = argument;
+
+    size_t begin = task * context->rows / context->tasks_amount;
+    size_t end = (task + 1) * context->rows / context->tasks_amount;
+
+    matrix_dot_block(end - begin, context->columns, context->inner, 1.0,
+                     context->first + begin * context->stride, context->stride,
+                     context->second, context->stride,
+                     context->destination + begin * context->stride, context->stride);
+}
+
+// tile coordinates of step ahead in an ( i, j, k ) traversal of tile products
+static void tiled_dot_prefetch(NCTiledMatrix* first, NCTiledMatrix* second, size_t step)
+{
+    size_t inner = first->tiles_across;
+    size_t k = step % inner;
+    size_t j = step / inner % second->tiles_across;
+    size_t i = step / inner / second->tiles_across;
+
+    tiled_matrix_prefetch(first, i, k);
+    tiled_matrix_prefetch(second, k, j);
+}
+
+void tiled_matrix_dot(NCTiledMatrix* destination, NCTiledMatrix* first, NCTiledMatrix* second)
+{
+    assert((first->columns == second->rows) && "First columns must be the same as second rows");
+    assert((first->rows == destination->rows && second->columns == destination->columns) && "Destination dimensions must be correct!");
+    assert((first->tile_size == second->tile_size && second->tile_size == destination->tile_size) && "Tiled matrices must have the same tile size!");
+    assert((destination != first && destination != second) && "Destination must be another matrix!");
+
+    NC_PROFILE_BEGIN("tiled_matrix_dot", 2.0 * destination->rows * destination->columns * first->columns, 0);
+
+    size_t inner = first->tiles_across;
+    size_t steps = destination->tiles_down * destination->tiles_across * inner;
+    size_t threads_amount = thread_pool_default()->threads_amount;
+
+    NCTiledDotContext context;
+
+    context.stride = destination->tile_size;
+
+    for (size_t step = 0; step < steps; step += inner)
+    {
+        size_t i = step / inner / destination->tiles_across;
+        size_t j = step / inner % destination->tiles_across;
+
+        // the output tile stays pinned while it accumulates, so it is never reloaded half-summed
+        NCMatrix output = tiled_matrix_acquire(destination, i, j, TILED_OVERWRITE);
+
+        matrix_zero(output);
+
+        for (size_t k = 0; k < inner; ++k)
+        {
+            for (size_t ahead = 1; ahead <= TILED_PREFETCH_DEPTH && step + k + ahead < steps; ++ahead)
+            {
+                tiled_dot_prefetch(first, second, step + k + ahead);
+            }
+
+            NCMatrix left = tiled_matrix_acquire(first, i, k, TILED_READ);
+            NCMatrix right = tiled_matrix_acquire(second, k, j, TILED_READ);
+
+            context.rows = tiled_matrix_tile_rows(destination, i);
+            context.columns = tiled_matrix_tile_columns(destination, j);
+            context.inner = tiled_matrix_tile_columns(first, k);
+            context.tasks_amount = context.rows < threads_amount ? context.rows : threads_amount;
+            context.first = left.numbers;
+            context.second = right.numbers;
+            context.destination = output.numbers;
+
+            thread_pool_run(thread_pool_default(), tiled_dot_task, &context, context.tasks_amount);
+
+            tiled_matrix_release(first, i, k);
+            tiled_matrix_release(second, k, j);
+        }
+
+        tiled_matrix_release(destination, i, j);
+    }
+
+    NC_PROFILE_END();
+}
+
+static void tiled_prefetch_ahead(NCTiledMatrix* matrix, size_t tile)
+{
+    size_t tiles = matrix->tiles_down * matrix->tiles_across;
+
+    for (size_t ahead = 1; ahead <= TILED_PREFETCH_DEPTH && tile + ahead < tiles; ++ahead)
+    {
+        tiled_matrix_prefetch(matrix, (tile + ahead) / matrix->tiles_across, (tile + ahead) % matrix->tiles_across);
+    }
+}
+
+static void tiled_binary(NCTiledMatrix* destination, NCTiledMatrix* first, NCTiledMatrix* second, tiled_binary_type operation)
+{
+    assert((first->rows == second->rows && second->rows == destination->rows) && "Matrix rows must be the same!");
+    assert((first->columns == second->columns && second->columns == destination->columns) && "Matrix columns must be the same!");
+    assert((first->tile_size == second->tile_size && second->tile_size == destination->tile_size) && "Tiled matrices must have the same tile size!");
+
+    size_t tiles = destination->tiles_down * destination->tiles_across;
+    NCTiledAccess access = destination == first || destination == second ? TILED_WRITE : TILED_OVERWRITE;
+
+    for (size_t t = 0; t < tiles; ++t)
+    {
+        size_t i = t / destination->tiles_across;
+        size_t j = t % destination->tiles_across;
+
+        tiled_prefetch_ahead(first, t);
+
+        if (second != first)
+        {
+            tiled_prefetch_ahead(second, t);
+        }
+
+        NCMatrix left = tiled_matrix_acquire(first, i, j, TILED_READ);
+        NCMatrix right = tiled_matrix_acquire(second, i, j, TILED_READ);
+        NCMatrix output = tiled_matrix_acquire(destination, i, j, access);
+
+        // padding takes part too, it is never read back
+        operation(output, left, right);
+
+        tiled_matrix_release(first, i, j);
+        tiled_matrix_release(second, i, j);
+        tiled_matrix_release(destination, i, j);
+    }
+}
+
+void tiled_matrix_sum(NCTiledMatrix* destination, NCTiledMatrix* first, NCTiledMatrix* second)
+{
+    tiled_binary(destination, first, second, matrix_sum);
+}
+
+void tiled_matrix_difference(NCTiledMatrix* destination, NCTiledMatrix* first, NCTiledMatrix* second)
+{
+    tiled_binary(destination, first, second, matrix_difference);
+}
+
+void tiled_matrix_multiply(NCTiledMatrix* destination, NCTiledMatrix* first, NCTiledMatrix* second)
+{
+    tiled_binary(destination, first, second, matrix_multiply);
+}
+
+void tiled_matrix_scale(NCTiledMatrix* matrix, double scalar)
+{
+    size_t tiles = matrix->tiles_down * matrix->tiles_across;
+
+    for (size_t t = 0; t < tiles; ++t)
+    {
+        tiled_prefetch_ahead(matrix, t);
+
+        NCMatrix tile = tiled_matrix_acquire(matrix, t / matrix->tiles_across, t % matrix->tiles_across, TILED_WRITE);
+
+        matrix_scale(tile, scalar);
+
+        tiled_matrix_release(matrix, t / matrix->tiles_across, t % matrix->tiles_across);
+    }
+}
+
+void apply_to_tiled_matrix(NCTiledMatrix* matrix, function_type function)
+{
+    size_t tiles = matrix->tiles_down * matrix->tiles_across;
+
+    for (size_t t = 0; t < tiles; ++t)
+    {
+        tiled_prefetch_ahead(matrix, t);
+
+        NCMatrix tile = tiled_matrix_acquire(matrix, t / matrix->tiles_across, t % matrix->tiles_across, TILED_WRITE);
+
+        apply_to_matrix(tile, function);
+
+        tiled_matrix_release(matrix, t / matrix->tiles_across, t % matrix->tiles_across);
+    }
+}
+
+typedef enum
+{
+    TILED_REDUCE_SUM,
+    TILED_REDUCE_MIN,
+    TILED_REDUCE_MAX
+} NCTiledReduction; // NumC Tiled reduction enumeration: sum, smallest or largest of the valid numbers
+
+static double tiled_reduce(NCTiledMatrix* matrix, NCTiledReduction reduction)
+{
+    size_t tiles = matrix->tiles_down * matrix->tiles_across;
+    double result = reduction == TILED_REDUCE_SUM ? 0 : reduction == TILED_REDUCE_MIN ? INFINITY : -INFINITY;
+
+    for (size_t t = 0; t < tiles; ++t)
+    {
+        size_t i = t / matrix->tiles_across;
+        size_t j = t % matrix->tiles_across;
+
+        tiled_prefetch_ahead(matrix, t);
+
+        NCMatrix tile = tiled_matrix_acquire(matrix, i, j, TILED_READ);
+        size_t rows = tiled_matrix_tile_rows(matrix, i);
+        size_t columns = tiled_matrix_tile_columns(matrix, j);
+
+        for (size_t row = 0; row < rows; ++row)
+        {
+            NCVector line = { columns, &MAT_AT(tile, row, 0) };
+
+            if (reduction == TILED_REDUCE_SUM)
+            {
+                for (size_t column = 0; column < columns; ++column)
+                {
+                    result += VEC_AT(line, column);
+                }
+            }
+            else if (reduction == TILED_REDUCE_MIN)
+            {
+                double value = vector_min(line);
+
+                result = value < result ? value : result;
+            }
+            else
+            {
+                double value = vector_max(line);
+
+                result = value > result ? value : result;
+            }
+        }
+
+        tiled_matrix_release(matrix, i, j);
+    }
+
+    return result;
+}
+
+double tiled_matrix_sum_of_values(NCTiledMatrix* matrix)
+{
+    return tiled_reduce(matrix, TILED_REDUCE_SUM);
+}
+
+double tiled_matrix_min(NCTiledMatrix* matrix)
+{
+    return tiled_reduce(matrix, TILED_REDUCE_MIN);
+}
+
+double tiled_matrix_max(NCTiledMatrix* matrix)
+{
+    return tiled_reduce(matrix, TILED_REDUCE_MAX);
+}
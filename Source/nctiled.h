@@ -0,0 +1,112 @@
+#ifndef NCTILED_H
+#define NCTILED_H
+
+#include <pthread.h>
+#include <stdint.h>
+
+#include "ncmatrix.h"
+#include "ncthread.h"
+
+/*
+ * Disk-backed matrices for data larger than memory.
+ *
+ * The file holds a header followed by square tiles of tile_size x tile_size numbers in row-major
+ * tile order; edge tiles are padded to the full size and their padding is never read.
+ * Tiles are cached in at most budget / tile bytes slots allocated on first use, least recently
+ * used unpinned tiles are written back when dirty and reused. A per-matrix thread serves
+ * tiled_matrix_prefetch requests, so the operations below ask for the next tiles of their
+ * traversal before computing on the current ones and loads overlap compute.
+ *
+ * Memory stays within the sum of budgets of the matrices involved, whatever their size.
+ * A matrix may be used by one operation at a time.
+ */
+
+#define TILED_PREFETCH_DEPTH 2 // tiles requested ahead of a traversal
+#define TILED_PREFETCH_QUEUE 16 // pending prefetch requests kept per matrix, newer ones are dropped when full
+#define TILED_MINIMUM_SLOTS (2 + TILED_PREFETCH_DEPTH) // two pinned tiles of one matrix and its prefetched ones
+
+typedef enum
+{
+    TILED_READ,
+    TILED_WRITE,
+    TILED_OVERWRITE
+} NCTiledAccess; // NumC Tiled access enumeration: read only, read and modify, or replace every number without loading
+
+typedef enum
+{
+    SLOT_EMPTY,
+    SLOT_LOADING,
+    SLOT_READY
+} NCTiledSlotState; // NumC Tiled slot state enumeration: unused, being written back or loaded, or holding a tile
+
+typedef struct
+{
+    NCTiledSlotState state;
+    size_t tile;
+    size_t previous;
+    size_t pins;
+    int dirty;
+    int writing;
+    unsigned long long used;
+    double* numbers;
+} NCTiledSlot; // NumC Tiled slot structure that contain: state, tile index, tile being written back while loading, amount of users, modified and writing flags, last use and tile data
+
+typedef struct
+{
+    unsigned long long loads;
+    unsigned long long prefetches;
+    unsigned long long writes;
+    unsigned long long stalls;
+} NCTiledStats; // NumC Tiled stats structure that contain: tiles read from disk, of them by the prefetch thread, tiles written back and acquires that had to wait or load themselves
+
+typedef struct
+{
+    size_t rows;
+    size_t columns;
+    size_t tile_size;
+    size_t tiles_down;
+    size_t tiles_across;
+    int file;
+
+    size_t slots_amount;
+    NCTiledSlot* slots;
+    unsigned long long clock;
+
+    pthread_t prefetcher;
+    pthread_mutex_t mutex;
+    pthread_cond_t changed;
+    pthread_cond_t requested;
+    size_t queue[TILED_PREFETCH_QUEUE];
+    size_t queue_first;
+    size_t queue_length;
+    int stopping;
+
+    NCTiledStats stats;
+} NCTiledMatrix; // NumC Tiled matrix structure that contain: shape, tile grid, backing file, tile cache, prefetch thread and its queue, stats
+
+NCTiledMatrix* tiled_matrix_create(const char* path, size_t rows, size_t columns, size_t tile_size, size_t budget); // creates a zero-filled tiled matrix file caching at most budget bytes of tiles, returns NULL when the file cannot be made
+NCTiledMatrix* tiled_matrix_open(const char* path, size_t budget); // opens an existing tiled matrix file, returns NULL when it cannot be read
+NCTiledMatrix* tiled_matrix_from_matrix(const char* path, NCMatrix matrix, size_t tile_size, size_t budget); // writes an in-memory Matrix into a new tiled matrix file
+void tiled_matrix_to_matrix(NCMatrix destination, NCTiledMatrix* matrix); // copies a tiled matrix into an in-memory Matrix of the same shape
+int tiled_matrix_close(NCTiledMatrix* matrix); // writes back modified tiles, stops the prefetch thread and frees the matrix, returns 0 when every tile was written
+
+NCMatrix tiled_matrix_acquire(NCTiledMatrix* matrix, size_t tile_row, size_t tile_column, NCTiledAccess access); // pins a tile in memory, loading it when needed, returns a tile_size x tile_size view, aborts when the tile cannot be read or its slot written back
+void tiled_matrix_release(NCTiledMatrix* matrix, size_t tile_row, size_t tile_column); // unpins a tile acquired before
+void tiled_matrix_prefetch(NCTiledMatrix* matrix, size_t tile_row, size_t tile_column); // asks the prefetch thread to load a tile, returns at once
+int tiled_matrix_flush(NCTiledMatrix* matrix); // writes back every modified cached tile, returns 0 on success and -1 when any write failed
+size_t tiled_matrix_tile_rows(NCTiledMatrix* matrix, size_t tile_row); // returns the amount of valid rows of tiles in given tile row
+size_t tiled_matrix_tile_columns(NCTiledMatrix* matrix, size_t tile_column); // returns the amount of valid columns of tiles in given tile column
+double tiled_matrix_at(NCTiledMatrix* matrix, size_t row, size_t column); // returns an element at given position
+NCTiledStats tiled_matrix_stats(NCTiledMatrix* matrix); // returns the tile traffic counters
+
+void tiled_matrix_dot(NCTiledMatrix* destination, NCTiledMatrix* first, NCTiledMatrix* second); // produces a matrix dot product between first and second tile by tile, destination must be another matrix with the same tile size
+void tiled_matrix_sum(NCTiledMatrix* destination, NCTiledMatrix* first, NCTiledMatrix* second); // produces an elementwise sum, any two of the matrices may be the same
+void tiled_matrix_difference(NCTiledMatrix* destination, NCTiledMatrix* first, NCTiledMatrix* second); // produces an elementwise difference, any two of the matrices may be the same
+void tiled_matrix_multiply(NCTiledMatrix* destination, NCTiledMatrix* first, NCTiledMatrix* second); // produces an elementwise product, any two of the matrices may be the same
+void tiled_matrix_scale(NCTiledMatrix* matrix, double scalar); // multiplies a tiled matrix by given scalar in-place
+void apply_to_tiled_matrix(NCTiledMatrix* matrix, function_type function); // apply a given function to each element of a tiled matrix in-place
+double tiled_matrix_sum_of_values(NCTiledMatrix* matrix); // returns a sum of all values
+double tiled_matrix_min(NCTiledMatrix* matrix); // returns the smallest element
+double tiled_matrix_max(NCTiledMatrix* matrix); // returns the largest element
+
+#endif // NCTILED_H
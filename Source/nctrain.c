@@ -0,0 +1,431 @@
+#include "nctrain.h"
+
+typedef struct
+{
+    size_t capacity;
+    NCMatrix* activations;
+    NCMatrix* pre_activations;
+    NCMatrix* deltas;
+    NCMatrix* gradients;
+    NCVector gradient;
+    int owns_gradient;
+    double loss;
+} NCTrainWorker; // NumC Train worker structure that contain: row capacity, per-layer activation, pre-activation and delta buffers, per-weight gradient views into one flat gradient, its ownership and loss sum
+
+typedef struct
+{
+    NCPerceptron model;
+    NCTrainWorker* workers;
+    const NCMatrix* train;
+    const NCMatrix* labels;
+    size_t samples_amount;
+    size_t shards_amount;
+    size_t first;
+    size_t amount;
+    size_t stride;
+    NCTrainConfig config;
+} NCTrainContext; // NumC Train context structure that contain: model, workers, data and the range or reduction stride of the current parallel step
+
+// the worker sharing the model gradient section uses it as its own gradient
+static NCTrainWorker train_worker_allocate(NCPerceptron model, size_t capacity, int shares_model_gradient)
+{
+    NCTrainWorker worker;
+    size_t layers_amount = perceptron_number_of_layers(model);
+
+    worker.capacity = capacity;
+    worker.activations = NC_MALLOC(sizeof(*worker.activations) * layers_amount, "train");
+    worker.pre_activations = NC_MALLOC(sizeof(*worker.pre_activations) * layers_amount, "train");
+    worker.deltas = NC_MALLOC(sizeof(*worker.deltas) * layers_amount, "train");
+    worker.gradients = NC_MALLOC(sizeof(*worker.gradients) * (layers_amount - 1), "train");
+    worker.loss = 0;
+
+    assert(worker.activations != NULL && worker.pre_activations != NULL && worker.deltas != NULL && worker.gradients != NULL);
+
+    for (size_t i = 0; i < layers_amount; ++i)
+    {
+        size_t neurons = layer_at_length(model.layers, i);
+
+        worker.activations[i] = matrix_allocate(capacity, neurons);
+        worker.pre_activations[i] = matrix_allocate(capacity, neurons);
+        worker.deltas[i] = matrix_allocate(capacity, neurons);
+    }
+
+    worker.gradient = perceptron_parameters(model, PARAMETERS_GRADIENTS);
+    worker.owns_gradient = !shares_model_gradient;
+
+    if (worker.owns_gradient)
+    {
+        worker.gradient.numbers = NC_ALIGNED_ALLOC(PARAMETERS_ALIGNMENT, sizeof(*worker.gradient.numbers) * worker.gradient.length, "train");
+
+        assert(worker.gradient.numbers != NULL);
+
+        vector_fill(worker.gradient, 0);
+    }
+
+    for (size_t i = 0; i < layers_amount - 1; ++i)
+    {
+        NCMatrix weight = perceptron_weight_at(model, i);
+        NCMatrix gradient = { weight.columns, weight.rows, worker.gradient.numbers + model.parameters.offsets[i] };
+
+        worker.gradients[i] = gradient;
+    }
+
+    return worker;
+}
+
+static void train_worker_delete(NCPerceptron model, NCTrainWorker worker)
+{
+    size_t layers_amount = perceptron_number_of_layers(model);
+
+    for (size_t i = 0; i < layers_amount; ++i)
+    {
+        matrix_delete(worker.activations[i]);
+        matrix_delete(worker.pre_activations[i]);
+        matrix_delete(worker.deltas[i]);
+    }
+
+    if (worker.owns_gradient)
+    {
+        NC_FREE(worker.gradient.numbers);
+    }
+
+    NC_FREE(worker.activations);
+    NC_FREE(worker.pre_activations);
+    NC_FREE(worker.deltas);
+    NC_FREE(worker.gradients);
+}
+
+#ifdef NUMC_PROFILE
+static double train_forward_flops(NCPerceptron model, size_t amount)
+{
+    double flops = 0;
+
+    for (size_t i = 0; i < model.weights.weights_amount; ++i)
+    {
+        NCMatrix weight = perceptron_weight_at(model, i);
+
+        flops += 2.0 * (double)amount * (double)weight.rows * (double)weight.columns;
+    }
+
+    return flops;
+}
+
+// gradient outer products for every Weight and delta propagation through all but the first one
+static double train_backward_flops(NCPerceptron model, size_t amount)
+{
+    NCMatrix first = perceptron_weight_at(model, 0);
+
+    return 2.0 * train_forward_flops(model, amount) - 2.0 * (double)amount * (double)first.rows * (double)first.columns;
+}
+#endif // NUMC_PROFILE
+
+static NCMatrix train_rows(NCMatrix matrix, size_t rows)
+{
+    matrix.rows = rows;
+
+    return matrix;
+}
+
+// propagates samples [first, first + amount) keeping pre-activations for backward
+static void train_forward(NCPerceptron model, NCTrainWorker* worker, const NCMatrix* train, size_t first, size_t amount)
+{
+    size_t layers_amount = perceptron_number_of_layers(model);
+
+    NC_PROFILE_BEGIN("perceptron_train_forward", train_forward_flops(model, amount), 0);
+
+    NCMatrix input = train_rows(worker->activations[0], amount);
+
+    for (size_t row = 0; row < amount; ++row)
+    {
+        memcpy(&MAT_AT(input, row, 0), train[first + row].numbers, sizeof(double) * input.columns);
+    }
+
+    for (size_t i = 1; i < layers_amount; ++i)
+    {
+        NCKernel kernel = model.kernels[i - 1];
+        NCMatrix pre_activation = train_rows(worker->pre_activations[i], amount);
+        NCMatrix activation = train_rows(worker->activations[i], amount);
+
+        kernel.dot(pre_activation, train_rows(worker->activations[i - 1], amount), perceptron_weight_at(model, i - 1));
+        matrix_copy(activation, pre_activation);
+        kernel.apply(activation, perceptron_activation_at(model, i));
+    }
+
+    NC_PROFILE_END();
+}
+
+// accumulates Weight gradients from the output deltas of amount rows, propagating deltas down to the first hidden Layer
+static void train_backward(NCPerceptron model, NCTrainWorker* worker, size_t amount)
+{
+    size_t output_index = perceptron_number_of_layers(model) - 1;
+
+    NC_PROFILE_BEGIN("perceptron_train_backward", train_backward_flops(model, amount), 0);
+
+    for (size_t i = output_index; i > 0; --i)
+    {
+        NCMatrix weight = perceptron_weight_at(model, i - 1);
+        NCMatrix gradient = worker->gradients[i - 1];
+        NCMatrix previous = worker->activations[i - 1];
+        NCMatrix delta = worker->deltas[i];
+
+        for (size_t row = 0; row < amount; ++row)
+        {
+            matrix_dot_block(weight.rows, weight.columns, 1, 1.0,
+                             &MAT_AT(previous, row, 0), 1,
+                             &MAT_AT(delta, row, 0), weight.columns,
+                             gradient.numbers, gradient.columns);
+        }
+
+        if (i == 1)
+        {
+            break;
+        }
+
+        NCMatrix previous_delta = worker->deltas[i - 1];
+        NCMatrix previous_pre = worker->pre_activations[i - 1];
+        function_type derivative = perceptron_activation_derivative_at(model, i - 1);
+
+        for (size_t row = 0; row < amount; ++row)
+        {
+            for (size_t j = 0; j < weight.rows; ++j)
+            {
+                double sum = 0;
+
+                for (size_t k = 0; k < weight.columns; ++k)
+                {
+                    sum += MAT_AT(weight, j, k) * MAT_AT(delta, row, k);
+                }
+
+                MAT_AT(previous_delta, row, j) = sum * derivative(MAT_AT(previous_pre, row, j));
+            }
+        }
+    }
+
+    NC_PROFILE_END();
+}
+
+// forward and backward of samples [first, first + amount) accumulated into worker gradients, returns the summed loss
+static double train_shard(NCPerceptron model, NCTrainWorker* worker, const NCMatrix* train, const NCMatrix* labels, size_t first, size_t amount, NCLoss loss_type)
+{
+    size_t output_index = perceptron_number_of_layers(model) - 1;
+    size_t output_length = layer_at_length(model.layers, output_index);
+    double loss = 0;
+
+    train_forward(model, worker, train, first, amount);
+
+    NCMatrix output = train_rows(worker->activations[output_index], amount);
+    NCMatrix output_pre = train_rows(worker->pre_activations[output_index], amount);
+    NCMatrix output_delta = train_rows(worker->deltas[output_index], amount);
+    function_type output_derivative = perceptron_activation_derivative_at(model, output_index);
+
+    for (size_t row = 0; row < amount; ++row)
+    {
+        const double* label = labels[first + row].numbers;
+
+        if (loss_type == LOSS_SOFTMAX_CROSS_ENTROPY)
+        {
+            NCMatrix logits = { output_length, 1, &MAT_AT(output, row, 0) };
+            NCMatrix gradient = { output_length, 1, &MAT_AT(output_delta, row, 0) };
+
+            loss += softmax_cross_entropy(gradient, logits, labels[first + row]);
+
+            for (size_t j = 0; j < output_length; ++j)
+            {
+                MAT_AT(output_delta, row, j) *= output_derivative(MAT_AT(output_pre, row, j));
+            }
+
+            continue;
+        }
+
+        for (size_t j = 0; j < output_length; ++j)
+        {
+            double difference = MAT_AT(output, row, j) - label[j];
+
+            loss += difference * difference / (double)output_length;
+            MAT_AT(output_delta, row, j) = 2 * difference / (double)output_length * output_derivative(MAT_AT(output_pre, row, j));
+        }
+    }
+
+    train_backward(model, worker, amount);
+
+    return loss;
+}
+
+static void train_worker_zero(NCTrainWorker* worker)
+{
+    vector_fill(worker->gradient, 0);
+
+    worker->loss = 0;
+}
+
+static void train_apply_gradient(NCPerceptron model, NCVector gradient, double scale, double momentum)
+{
+    NCVector weights = perceptron_parameters(model, PARAMETERS_WEIGHTS);
+
+    NC_PROFILE_BEGIN("perceptron_train_update", (momentum == 0 ? 2.0 : 5.0) * (double)gradient.length, (momentum == 0 ? 3.0 : 6.0) * sizeof(double) * (double)gradient.length);
+
+    if (momentum == 0)
+    {
+        vector_axpy(weights, -scale, gradient);
+    }
+    else
+    {
+        NCVector velocities = perceptron_parameters(model, PARAMETERS_VELOCITIES);
+
+        vector_axpby(velocities, 1.0, gradient, momentum);
+        vector_axpy(weights, -scale, velocities);
+    }
+
+    NC_PROFILE_END();
+}
+
+static void train_synchronous_shard(void* argument, size_t shard)
+{
+    NCTrainContext* context = argument;
+    NCTrainWorker* worker = &context->workers[shard];
+
+    size_t begin = context->first + shard * context->amount / context->shards_amount;
+    size_t end = context->first + (shard + 1) * context->amount / context->shards_amount;
+
+    train_worker_zero(worker);
+
+    if (end > begin)
+    {
+        worker->loss = train_shard(context->model, worker, context->train, context->labels, begin, end - begin, context->config.loss);
+    }
+}
+
+static void train_reduce_pair(void* argument, size_t pair)
+{
+    NCTrainContext* context = argument;
+
+    size_t target = pair * 2 * context->stride;
+    size_t source = target + context->stride;
+
+    if (source >= context->shards_amount)
+    {
+        return;
+    }
+
+    NCTrainWorker* destination = &context->workers[target];
+    NCTrainWorker* partner = &context->workers[source];
+
+    NC_PROFILE_BEGIN("perceptron_train_reduce", (double)destination->gradient.length, 3.0 * sizeof(double) * (double)destination->gradient.length);
+
+    vector_sum(destination->gradient, destination->gradient, partner->gradient);
+
+    NC_PROFILE_END();
+
+    destination->loss += partner->loss;
+}
+
+static void train_hogwild_shard(void* argument, size_t shard)
+{
+    NCTrainContext* context = argument;
+    NCTrainWorker* worker = &context->workers[shard];
+
+    size_t begin = shard * context->samples_amount / context->shards_amount;
+    size_t end = (shard + 1) * context->samples_amount / context->shards_amount;
+    double loss = 0;
+
+    for (size_t first = begin; first < end; first += worker->capacity)
+    {
+        size_t amount = first + worker->capacity < end ? worker->capacity : end - first;
+
+        train_worker_zero(worker);
+        loss += train_shard(context->model, worker, context->train, context->labels, first, amount, context->config.loss);
+
+        // racy by design: other shards read and write the same weights concurrently
+        train_apply_gradient(context->model, worker->gradient, context->config.learning_rate / (double)amount, context->config.momentum);
+    }
+
+    worker->loss = loss;
+}
+
+double perceptron_train_parallel(NCPerceptron model, const NCMatrix* train, const NCMatrix* labels, size_t samples_amount, NCTrainConfig config)
+{
+    assert((config.batch_size > 0) && "Train batch size must be positive!");
+    assert((samples_amount > 0) && "Train data must not be empty!");
+
+    size_t layers_amount = perceptron_number_of_layers(model);
+
+    for (size_t i = 0; i < samples_amount; ++i)
+    {
+        assert((train[i].rows == 1 && train[i].columns == layer_at_length(model.layers, 0)) && "Train sample and Input Layer are incompatible");
+        assert((labels[i].rows == 1 && labels[i].columns == layer_at_length(model.layers, layers_amount - 1)) && "Label and Output Layer are incompatible");
+    }
+
+    NCThreadPool* pool = thread_pool_default();
+
+    NCTrainContext context;
+
+    context.model = model;
+    context.train = train;
+    context.labels = labels;
+    context.samples_amount = samples_amount;
+    context.shards_amount = config.shards_amount > 0 ? config.shards_amount : pool->threads_amount;
+    context.config = config;
+
+    // synchronous shards split one mini-batch, Hogwild shards step with the same per-shard rows
+    size_t capacity = (config.batch_size + context.shards_amount - 1) / context.shards_amount;
+
+    context.workers = NC_MALLOC(sizeof(*context.workers) * context.shards_amount, "train");
+    assert(context.workers != NULL);
+
+    for (size_t i = 0; i < context.shards_amount; ++i)
+    {
+        context.workers[i] = train_worker_allocate(model, capacity > 0 ? capacity : 1, i == 0);
+    }
+
+    double epoch_loss = 0;
+
+    for (size_t epoch = 0; epoch < config.epochs; ++epoch)
+    {
+        NC_PROFILE_BEGIN("perceptron_train_epoch", 0, 0);
+
+        epoch_loss = 0;
+
+        if (config.mode == TRAIN_HOGWILD)
+        {
+            thread_pool_run(pool, train_hogwild_shard, &context, context.shards_amount);
+
+            for (size_t i = 0; i < context.shards_amount; ++i)
+            {
+                epoch_loss += context.workers[i].loss;
+            }
+        }
+        else
+        {
+            for (size_t first = 0; first < samples_amount; first += config.batch_size)
+            {
+                context.first = first;
+                context.amount = first + config.batch_size < samples_amount ? config.batch_size : samples_amount - first;
+
+                thread_pool_run(pool, train_synchronous_shard, &context, context.shards_amount);
+
+                for (context.stride = 1; context.stride < context.shards_amount; context.stride *= 2)
+                {
+                    size_t pairs = (context.shards_amount + 2 * context.stride - 1) / (2 * context.stride);
+
+                    thread_pool_run(pool, train_reduce_pair, &context, pairs);
+                }
+
+                train_apply_gradient(model, context.workers[0].gradient, config.learning_rate / (double)context.amount, config.momentum);
+                epoch_loss += context.workers[0].loss;
+            }
+        }
+
+        epoch_loss /= (double)samples_amount;
+
+        NC_PROFILE_END();
+    }
+
+    for (size_t i = 0; i < context.shards_amount; ++i)
+    {
+        train_worker_delete(model, context.workers[i]);
+    }
+
+    NC_FREE(context.workers);
+
+    return epoch_loss;
+}
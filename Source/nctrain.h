@@ -0,0 +1,48 @@
+#ifndef NCTRAIN_H
+#define NCTRAIN_H
+
+#include "numc.h"
+#include "ncthread.h"
+
+/*
+ * Data-parallel mini-batch training on the default thread pool.
+ *
+ * TRAIN_SYNCHRONOUS splits every mini-batch into shards_amount contiguous shards, each shard
+ * runs forward and backward into its own activation and gradient buffers against the shared
+ * weights, shard gradients are summed by a pairwise tree and a single SGD update is applied.
+ * Results depend only on shards_amount, never on scheduling.
+ *
+ * Gradients live in flat buffers laid out like the model parameters, the first shard reduces
+ * into the PARAMETERS_GRADIENTS section of the model, so every reduction and update is a single
+ * sweep over one Vector. With a momentum the update goes through PARAMETERS_VELOCITIES.
+ *
+ * TRAIN_HOGWILD gives each shard a contiguous slice of the epoch and lets it update the shared
+ * weights after every step without any locking, trading determinism for no synchronization.
+ */
+
+typedef enum
+{
+    TRAIN_SYNCHRONOUS,
+    TRAIN_HOGWILD
+} NCTrainMode; // NumC Train mode enumeration: synchronous reduction or lock-free Hogwild updates
+
+typedef enum
+{
+    LOSS_MEAN_SQUARED_ERROR,
+    LOSS_SOFTMAX_CROSS_ENTROPY
+} NCLoss; // NumC Loss enumeration: mean squared error of outputs or cross-entropy of softmax over output logits
+
+typedef struct
+{
+    size_t epochs;
+    size_t batch_size;
+    size_t shards_amount;
+    double learning_rate;
+    NCTrainMode mode;
+    NCLoss loss;
+    double momentum;
+} NCTrainConfig; // NumC Train config structure that contain: epochs, mini-batch size, amount of shards ( 0 for one per pool thread ), learning rate, mode, loss and SGD momentum ( 0 for plain SGD )
+
+double perceptron_train_parallel(NCPerceptron model, const NCMatrix* train, const NCMatrix* labels, size_t samples_amount, NCTrainConfig config); // trains the model with the configured loss and returns the mean loss of the last epoch
+
+#endif // NCTRAIN_H
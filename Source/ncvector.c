@@ -1,5 +1,298 @@
 #include "ncvector.h"
 
+#if defined(__AVX__)
+#include <immintrin.h>
+#define SIMD_WIDTH 4
+#define SIMD_ALIGNMENT 32
+typedef __m256d simd_type;
+#define simd_load(pointer) _mm256_load_pd(pointer)
+#define simd_loadu(pointer) _mm256_loadu_pd(pointer)
+#define simd_store(pointer, value) _mm256_store_pd((pointer), (value))
+#define simd_storeu(pointer, value) _mm256_storeu_pd((pointer), (value))
+#define simd_set1(value) _mm256_set1_pd(value)
+#define simd_add(first, second) _mm256_add_pd((first), (second))
+#define simd_mul(first, second) _mm256_mul_pd((first), (second))
+#define simd_div(first, second) _mm256_div_pd((first), (second))
+#define simd_min(first, second) _mm256_min_pd((first), (second))
+#define simd_max(first, second) _mm256_max_pd((first), (second))
+#if defined(__FMA__)
+#define simd_fmadd(first, second, third) _mm256_fmadd_pd((first), (second), (third))
+#endif // __FMA__
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#define SIMD_WIDTH 2
+#define SIMD_ALIGNMENT 16
+typedef __m128d simd_type;
+#define simd_load(pointer) _mm_load_pd(pointer)
+#define simd_loadu(pointer) _mm_loadu_pd(pointer)
+#define simd_store(pointer, value) _mm_store_pd((pointer), (value))
+#define simd_storeu(pointer, value) _mm_storeu_pd((pointer), (value))
+#define simd_set1(value) _mm_set1_pd(value)
+#define simd_add(first, second) _mm_add_pd((first), (second))
+#define simd_mul(first, second) _mm_mul_pd((first), (second))
+#define simd_div(first, second) _mm_div_pd((first), (second))
+#define simd_min(first, second) _mm_min_pd((first), (second))
+#define simd_max(first, second) _mm_max_pd((first), (second))
+#else
+#define SIMD_WIDTH 1
+#define SIMD_ALIGNMENT 8
+typedef double simd_type;
+#define simd_load(pointer) (*(pointer))
+#define simd_loadu(pointer) (*(pointer))
+#define simd_store(pointer, value) (*(pointer) = (value))
+#define simd_storeu(pointer, value) (*(pointer) = (value))
+#define simd_set1(value) (value)
+#define simd_add(first, second) ((first) + (second))
+#define simd_mul(first, second) ((first) * (second))
+#define simd_div(first, second) ((first) / (second))
+#define simd_min(first, second) ((first) < (second) ? (first) : (second))
+#define simd_max(first, second) ((first) > (second) ? (first) : (second))
+#endif // SIMD
+
+#ifndef simd_fmadd
+#define simd_fmadd(first, second, third) simd_add(simd_mul((first), (second)), (third))
+#endif // simd_fmadd
+
+#define VECTOR_MAX_CHUNKS 64
+#define VECTOR_CHUNK_GRANULARITY 8
+
+typedef struct NCVectorTask NCVectorTask;
+typedef void (*vector_kernel_type)(NCVectorTask* task, size_t begin, size_t end, size_t chunk);
+
+struct NCVectorTask
+{
+    vector_kernel_type kernel;
+    double* destination;
+    const double* first;
+    const double* second;
+    double first_scalar;
+    double second_scalar;
+    size_t length;
+    size_t chunks;
+    double values[VECTOR_MAX_CHUNKS];
+}; // NumC Vector task structure that contain: kernel, operands, scalars and per-chunk partial results of one BLAS-1 operation
+
+static NCVectorTask vector_task(vector_kernel_type kernel, double* destination, const double* first, const double* second,
+                                double first_scalar, double second_scalar, size_t length)
+{
+    NCVectorTask task;
+
+    task.kernel = kernel;
+    task.destination = destination;
+    task.first = first;
+    task.second = second;
+    task.first_scalar = first_scalar;
+    task.second_scalar = second_scalar;
+    task.length = length;
+    task.chunks = 1;
+
+    return task;
+}
+
+static void vector_task_chunk(void* context, size_t chunk)
+{
+    NCVectorTask* task = context;
+
+    size_t per_chunk = (task->length / task->chunks + VECTOR_CHUNK_GRANULARITY) / VECTOR_CHUNK_GRANULARITY * VECTOR_CHUNK_GRANULARITY;
+    size_t begin = chunk * per_chunk;
+    size_t end = begin + per_chunk < task->length ? begin + per_chunk : task->length;
+
+    if (begin < end)
+    {
+        task->kernel(task, begin, end, chunk);
+    }
+}
+
+// runs the task inline below VECTOR_PARALLEL_THRESHOLD, otherwise one chunk per pool thread, reductions pre-fill values with a neutral element
+static void vector_run(NCVectorTask* task, double neutral)
+{
+    NCThreadPool* pool = task->length < VECTOR_PARALLEL_THRESHOLD ? NULL : thread_pool_default();
+
+    task->chunks = pool == NULL ? 1 : (pool->threads_amount < VECTOR_MAX_CHUNKS ? pool->threads_amount : VECTOR_MAX_CHUNKS);
+
+    for (size_t i = 0; i < task->chunks; ++i)
+    {
+        task->values[i] = neutral;
+    }
+
+    if (task->chunks == 1)
+    {
+        task->kernel(task, 0, task->length, 0);
+        return;
+    }
+
+    thread_pool_run(pool, vector_task_chunk, task, task->chunks);
+}
+
+// first index at or after begin where destination is SIMD aligned, never past end
+static size_t vector_aligned_start(const double* destination, size_t begin, size_t end)
+{
+    size_t misalignment = (uintptr_t)(destination + begin) % SIMD_ALIGNMENT;
+    size_t head = misalignment == 0 ? 0 : (SIMD_ALIGNMENT - misalignment) / sizeof(double);
+
+    return begin + head < end ? begin + head : end;
+}
+
+// elementwise kernel over [begin, end): scalar head until destination is aligned, aligned stores with unaligned source loads, scalar tail
+#define VECTOR_ELEMENTWISE_KERNEL(name, simd_statement, scalar_statement)           \
+static void name(NCVectorTask* task, size_t begin, size_t end, size_t chunk)      \
+{                                                                                 \
+    double* y = task->destination;                                                \
+    const double* a = task->first;                                                \
+    const double* b = task->second;                                               \
+    double alpha = task->first_scalar;                                            \
+    double beta = task->second_scalar;                                            \
+    simd_type alpha_simd = simd_set1(alpha);                                      \
+    simd_type beta_simd = simd_set1(beta);                                        \
+    size_t aligned = vector_aligned_start(y, begin, end);                         \
+    size_t i = begin;                                                             \
+                                                                                  \
+    (void)a; (void)b; (void)alpha_simd; (void)beta_simd; (void)chunk;             \
+                                                                                  \
+    for (; i < aligned; ++i) { scalar_statement; }                                \
+    for (; i + SIMD_WIDTH <= end; i += SIMD_WIDTH) { simd_statement; }            \
+    for (; i < end; ++i) { scalar_statement; }                                    \
+}
+
+VECTOR_ELEMENTWISE_KERNEL(vector_axpy_kernel,
+                          simd_store(y + i, simd_fmadd(alpha_simd, simd_loadu(a + i), simd_load(y + i))),
+                          y[i] += alpha * a[i])
+
+VECTOR_ELEMENTWISE_KERNEL(vector_axpby_kernel,
+                          simd_store(y + i, simd_fmadd(alpha_simd, simd_loadu(a + i), simd_mul(beta_simd, simd_load(y + i)))),
+                          y[i] = alpha * a[i] + beta * y[i])
+
+VECTOR_ELEMENTWISE_KERNEL(vector_sum_kernel,
+                          simd_store(y + i, simd_add(simd_loadu(a + i), simd_loadu(b + i))),
+                          y[i] = a[i] + b[i])
+
+VECTOR_ELEMENTWISE_KERNEL(vector_multiply_kernel,
+                          simd_store(y + i, simd_mul(simd_loadu(a + i), simd_loadu(b + i))),
+                          y[i] = a[i] * b[i])
+
+VECTOR_ELEMENTWISE_KERNEL(vector_divide_kernel,
+                          simd_store(y + i, simd_div(simd_loadu(a + i), simd_loadu(b + i))),
+                          y[i] = a[i] / b[i])
+
+VECTOR_ELEMENTWISE_KERNEL(vector_fma_kernel,
+                          simd_store(y + i, simd_fmadd(simd_loadu(a + i), simd_loadu(b + i), simd_load(y + i))),
+                          y[i] += a[i] * b[i])
+
+VECTOR_ELEMENTWISE_KERNEL(vector_scale_kernel,
+                          simd_store(y + i, simd_mul(alpha_simd, simd_load(y + i))),
+                          y[i] *= alpha)
+
+// simd_min and simd_max return their second operand when either is NaN, so the element goes second to keep NaN like the scalar path
+VECTOR_ELEMENTWISE_KERNEL(vector_clamp_kernel,
+                          simd_store(y + i, simd_min(beta_simd, simd_max(alpha_simd, simd_load(y + i)))),
+                          y[i] = y[i] < alpha ? alpha : (y[i] > beta ? beta : y[i]))
+
+VECTOR_ELEMENTWISE_KERNEL(vector_fill_kernel,
+                          simd_store(y + i, alpha_simd),
+                          y[i] = alpha)
+
+static void vector_copy_kernel(NCVectorTask* task, size_t begin, size_t end, size_t chunk)
+{
+    (void)chunk;
+
+    memcpy(task->destination + begin, task->first + begin, sizeof(double) * (end - begin));
+}
+
+static void vector_swap_kernel(NCVectorTask* task, size_t begin, size_t end, size_t chunk)
+{
+    double* y = task->destination;
+    double* x = (double*)task->first;
+    size_t i = begin;
+
+    (void)chunk;
+
+    for (; i + SIMD_WIDTH <= end; i += SIMD_WIDTH)
+    {
+        simd_type first = simd_loadu(y + i);
+        simd_type second = simd_loadu(x + i);
+
+        simd_storeu(y + i, second);
+        simd_storeu(x + i, first);
+    }
+
+    for (; i < end; ++i)
+    {
+        double temporary = y[i];
+        y[i] = x[i];
+        x[i] = temporary;
+    }
+}
+
+static double simd_reduce_sum(simd_type value)
+{
+    double lanes[SIMD_WIDTH];
+    double sum = 0;
+
+    simd_storeu(lanes, value);
+
+    for (size_t i = 0; i < SIMD_WIDTH; ++i)
+    {
+        sum += lanes[i];
+    }
+
+    return sum;
+}
+
+static void vector_dot_kernel(NCVectorTask* task, size_t begin, size_t end, size_t chunk)
+{
+    const double* a = task->first;
+    const double* b = task->second;
+    simd_type accumulator = simd_set1(0.0);
+    size_t i = begin;
+
+    for (; i + SIMD_WIDTH <= end; i += SIMD_WIDTH)
+    {
+        accumulator = simd_fmadd(simd_loadu(a + i), simd_loadu(b + i), accumulator);
+    }
+
+    double sum = simd_reduce_sum(accumulator);
+
+    for (; i < end; ++i)
+    {
+        sum += a[i] * b[i];
+    }
+
+    task->values[chunk] = sum;
+}
+
+#define VECTOR_EXTREMUM_KERNEL(name, simd_operation, better)                        \
+static void name(NCVectorTask* task, size_t begin, size_t end, size_t chunk)      \
+{                                                                                 \
+    const double* a = task->first;                                                \
+    simd_type accumulator = simd_set1(a[begin]);                                  \
+    double lanes[SIMD_WIDTH];                                                     \
+    size_t i = begin;                                                             \
+                                                                                  \
+    for (; i + SIMD_WIDTH <= end; i += SIMD_WIDTH)                                \
+    {                                                                             \
+        accumulator = simd_operation(accumulator, simd_loadu(a + i));             \
+    }                                                                             \
+                                                                                  \
+    simd_storeu(lanes, accumulator);                                              \
+                                                                                  \
+    double result = lanes[0];                                                     \
+                                                                                  \
+    for (size_t lane = 1; lane < SIMD_WIDTH; ++lane)                              \
+    {                                                                             \
+        result = lanes[lane] better result ? lanes[lane] : result;                \
+    }                                                                             \
+                                                                                  \
+    for (; i < end; ++i)                                                          \
+    {                                                                             \
+        result = a[i] better result ? a[i] : result;                              \
+    }                                                                             \
+                                                                                  \
+    task->values[chunk] = result;                                                 \
+}
+
+VECTOR_EXTREMUM_KERNEL(vector_min_kernel, simd_min, <)
+VECTOR_EXTREMUM_KERNEL(vector_max_kernel, simd_max, >)
+
 static long long get_seed()
 {
     static long long SEED = 0;
@@ -12,7 +305,7 @@ NCVector vector_allocate(size_t points)
     NCVector result;
 
     result.length = points;
-    result.numbers = malloc(sizeof(*result.numbers) * points);
+    result.numbers = NC_MALLOC(sizeof(*result.numbers) * points, "vector");
 
     assert(result.numbers != NULL);
 
@@ -40,11 +333,14 @@ double vector_dot(NCVector first, NCVector second)
 {
     assert((first.length == second.length) && "Lengths of the vectors must be the same!");
 
+    NCVectorTask task = vector_task(vector_dot_kernel, NULL, first.numbers, second.numbers, 0, 0, first.length);
+    vector_run(&task, 0.0);
+
     double sum = 0;
 
-    for (size_t i = 0; i < first.length; ++i)
+    for (size_t i = 0; i < task.chunks; ++i)
     {
-        sum += VEC_AT(first, i) * VEC_AT(second, i);
+        sum += task.values[i];
     }
 
     return sum;
@@ -52,32 +348,21 @@ double vector_dot(NCVector first, NCVector second)
 
 double vector_magnitude(NCVector vector)
 {
-    double result = 0;
-
-    for (size_t i = 0; i < vector.length; ++i)
-    {
-        result += pow(VEC_AT(vector, i), 2);
-    }
-
-    return sqrt(result);
+    return sqrt(vector_dot(vector, vector));
 }
 
 void vector_sum(NCVector destination, NCVector first, NCVector second)
 {
     assert((first.length == second.length && second.length == destination.length) && "Lengths of the vectors must be the same!");
 
-    for (size_t i = 0; i < destination.length; ++i)
-    {
-        VEC_AT(destination, i) = VEC_AT(first, i) + VEC_AT(second, i);
-    }
+    NCVectorTask task = vector_task(vector_sum_kernel, destination.numbers, first.numbers, second.numbers, 0, 0, destination.length);
+    vector_run(&task, 0.0);
 }
 
 void vector_scale(NCVector vector, double scalar)
 {
-    for (size_t i = 0; i < vector.length; ++i)
-    {
-        VEC_AT(vector, i) *= scalar;
-    }
+    NCVectorTask task = vector_task(vector_scale_kernel, vector.numbers, NULL, NULL, scalar, 0, vector.length);
+    vector_run(&task, 0.0);
 }
 
 void vector_print(NCVector vector)
@@ -108,7 +393,133 @@ void apply_to_vector(NCVector vector, function_type function)
     }
 }
 
+void vector_axpy(NCVector destination, double scalar, NCVector source)
+{
+    assert((destination.length == source.length) && "Lengths of the vectors must be the same!");
+
+    NCVectorTask task = vector_task(vector_axpy_kernel, destination.numbers, source.numbers, NULL, scalar, 0, destination.length);
+    vector_run(&task, 0.0);
+}
+
+void vector_axpby(NCVector destination, double first_scalar, NCVector source, double second_scalar)
+{
+    assert((destination.length == source.length) && "Lengths of the vectors must be the same!");
+
+    NCVectorTask task = vector_task(vector_axpby_kernel, destination.numbers, source.numbers, NULL, first_scalar, second_scalar, destination.length);
+    vector_run(&task, 0.0);
+}
+
+void vector_multiply(NCVector destination, NCVector first, NCVector second)
+{
+    assert((first.length == second.length && second.length == destination.length) && "Lengths of the vectors must be the same!");
+
+    NCVectorTask task = vector_task(vector_multiply_kernel, destination.numbers, first.numbers, second.numbers, 0, 0, destination.length);
+    vector_run(&task, 0.0);
+}
+
+void vector_divide(NCVector destination, NCVector first, NCVector second)
+{
+    assert((first.length == second.length && second.length == destination.length) && "Lengths of the vectors must be the same!");
+
+    NCVectorTask task = vector_task(vector_divide_kernel, destination.numbers, first.numbers, second.numbers, 0, 0, destination.length);
+    vector_run(&task, 0.0);
+}
+
+void vector_fma(NCVector destination, NCVector first, NCVector second)
+{
+    assert((first.length == second.length && second.length == destination.length) && "Lengths of the vectors must be the same!");
+
+    NCVectorTask task = vector_task(vector_fma_kernel, destination.numbers, first.numbers, second.numbers, 0, 0, destination.length);
+    vector_run(&task, 0.0);
+}
+
+double vector_min(NCVector vector)
+{
+    assert((vector.length > 0) && "Vector must not be empty!");
+
+    NCVectorTask task = vector_task(vector_min_kernel, NULL, vector.numbers, NULL, 0, 0, vector.length);
+    vector_run(&task, INFINITY);
+
+    double result = task.values[0];
+
+    for (size_t i = 1; i < task.chunks; ++i)
+    {
+        result = task.values[i] < result ? task.values[i] : result;
+    }
+
+    return result;
+}
+
+double vector_max(NCVector vector)
+{
+    assert((vector.length > 0) && "Vector must not be empty!");
+
+    NCVectorTask task = vector_task(vector_max_kernel, NULL, vector.numbers, NULL, 0, 0, vector.length);
+    vector_run(&task, -INFINITY);
+
+    double result = task.values[0];
+
+    for (size_t i = 1; i < task.chunks; ++i)
+    {
+        result = task.values[i] > result ? task.values[i] : result;
+    }
+
+    return result;
+}
+
+size_t vector_argmax(NCVector vector)
+{
+    double maximum = vector_max(vector);
+
+    for (size_t i = 0; i < vector.length; ++i)
+    {
+        if (VEC_AT(vector, i) == maximum)
+        {
+            return i;
+        }
+    }
+
+    return 0;
+}
+
+void vector_clamp(NCVector vector, double minimum, double maximum)
+{
+    assert((minimum <= maximum) && "Clamp minimum must not exceed maximum!");
+
+    NCVectorTask task = vector_task(vector_clamp_kernel, vector.numbers, NULL, NULL, minimum, maximum, vector.length);
+    vector_run(&task, 0.0);
+}
+
+void vector_copy(NCVector destination, NCVector source)
+{
+    assert((destination.length == source.length) && "Lengths of the vectors must be the same!");
+
+    // chunks of an overlapping copy would race with each other, so it moves the whole range at once
+    if (destination.numbers < source.numbers + source.length && source.numbers < destination.numbers + destination.length)
+    {
+        memmove(destination.numbers, source.numbers, sizeof(double) * destination.length);
+        return;
+    }
+
+    NCVectorTask task = vector_task(vector_copy_kernel, destination.numbers, source.numbers, NULL, 0, 0, destination.length);
+    vector_run(&task, 0.0);
+}
+
+void vector_fill(NCVector vector, double value)
+{
+    NCVectorTask task = vector_task(vector_fill_kernel, vector.numbers, NULL, NULL, value, 0, vector.length);
+    vector_run(&task, 0.0);
+}
+
+void vector_swap(NCVector first, NCVector second)
+{
+    assert((first.length == second.length) && "Lengths of the vectors must be the same!");
+
+    NCVectorTask task = vector_task(vector_swap_kernel, first.numbers, second.numbers, NULL, 0, 0, first.length);
+    vector_run(&task, 0.0);
+}
+
 void vector_delete(NCVector vector)
 {
-    free(vector.numbers);
+    NC_FREE(vector.numbers);
 }
\ No newline at end of file
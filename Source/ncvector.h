@@ -6,6 +6,10 @@
 typedef double (*function_type)(double x);
 #endif // FUNCTION_TYPE
 
+#ifndef VECTOR_PARALLEL_THRESHOLD
+#define VECTOR_PARALLEL_THRESHOLD 65536 // vectors at least this long are split across the default thread pool
+#endif // VECTOR_PARALLEL_THRESHOLD
+
 #ifndef VEC_AT
 #define VEC_AT(vector, i) (vector).numbers[(i)]
 #endif // VEC_AT
@@ -16,6 +20,11 @@ typedef double (*function_type)(double x);
 #include <math.h>
 #include <malloc.h>
 #include <time.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "ncthread.h"
+#include "ncmemory.h"
 
 typedef struct
 {
@@ -35,6 +44,18 @@ void vector_scale(NCVector vector, double scalar); // multiplies a vector by giv
 void vector_print(NCVector vector); // prints a vector
 void vector_random(NCVector vector); // feels a vector with random numbers in range (0, 1)
 void apply_to_vector(NCVector vector, function_type function); // // apply a given function to each element of a vector ( in-place )
+void vector_axpy(NCVector destination, double scalar, NCVector source); // destination += scalar * source
+void vector_axpby(NCVector destination, double first_scalar, NCVector source, double second_scalar); // destination = first_scalar * source + second_scalar * destination
+void vector_multiply(NCVector destination, NCVector first, NCVector second); // elementwise product of first and second into destination
+void vector_divide(NCVector destination, NCVector first, NCVector second); // elementwise quotient of first and second into destination
+void vector_fma(NCVector destination, NCVector first, NCVector second); // destination += first * second elementwise
+double vector_min(NCVector vector); // returns the smallest element
+double vector_max(NCVector vector); // returns the largest element
+size_t vector_argmax(NCVector vector); // returns the position of the first largest element
+void vector_clamp(NCVector vector, double minimum, double maximum); // clamps every element into [minimum, maximum] in-place, NaN elements stay NaN
+void vector_copy(NCVector destination, NCVector source); // copies data from source Vector into destination Vector, overlapping Vectors are copied serially
+void vector_fill(NCVector vector, double value); // fills a vector with given value
+void vector_swap(NCVector first, NCVector second); // exchanges data of two vectors
 void vector_delete(NCVector vector); // deletes the vector
 
 #endif // NCVECTOR_H
@@ -1,10 +1,20 @@
 #include "numc.h"
 
+#define SOFTMAX_CHUNK 64
+#define CHECKPOINT_MAGIC "NCCHECK"
+
+typedef struct
+{
+    char magic[8];
+    uint64_t layers_amount;
+    uint64_t length;
+} NCCheckpointHeader; // NumC Checkpoint header structure that contain: magic, amount of Layers and numbers per parameter section as stored at the start of the file
+
 
 
 double* linspace(double start, double end, size_t amount)
 {
-    double *result = (double*)malloc(amount * sizeof(double));
+    double *result = (double*)NC_MALLOC(amount * sizeof(double), "array");
 
     assert(result != NULL);
 
@@ -20,7 +30,7 @@ double* linspace(double start, double end, size_t amount)
 
 double* apply_to_array(const double *array, const size_t length, function_type function)
 {
-    double* result = (double*)malloc(length * sizeof(double));
+    double* result = (double*)NC_MALLOC(length * sizeof(double), "array");
 
     for (size_t i = 0; i < length; i++)
     {
@@ -35,7 +45,8 @@ NCWeights weights_allocate(size_t number_of_layers)
     NCWeights result;
 
     result.weights_amount = number_of_layers;
-    result.matrices = malloc(sizeof(*result.matrices) * number_of_layers);
+    result.matrices = NC_MALLOC(sizeof(*result.matrices) * number_of_layers, "perceptron");
+    result.owns_matrices = 1;
 
     assert(result.matrices != NULL);
 
@@ -69,13 +80,25 @@ void weights_print(NCWeights weights)
     }
 }
 
+void weights_delete(NCWeights weights)
+{
+    assert((weights.owns_matrices) && "Weights of a Perceptron are deleted by perceptron_delete!");
+
+    for (size_t i = 0; i < weights.weights_amount; ++i)
+    {
+        matrix_delete(weights.matrices[i]);
+    }
+
+    NC_FREE(weights.matrices);
+}
+
 NCActivations activations_allocate(size_t number_of_activations)
 {
     NCActivations result;
 
     result.activations_amount = number_of_activations;
-    result.activations = malloc(sizeof(*result.activations) * number_of_activations);
-    result.activations_derivatives = malloc(sizeof(*result.activations_derivatives) * number_of_activations);
+    result.activations = NC_MALLOC(sizeof(*result.activations) * number_of_activations, "perceptron");
+    result.activations_derivatives = NC_MALLOC(sizeof(*result.activations_derivatives) * number_of_activations, "perceptron");
 
     assert(result.activations != NULL);
     assert(result.activations_derivatives != NULL);
@@ -89,12 +112,18 @@ void activations_initialize(NCActivations structure, function_type *activations,
     structure.activations_derivatives = activation_derivatives;
 }
 
+void activations_delete(NCActivations structure)
+{
+    NC_FREE(structure.activations);
+    NC_FREE(structure.activations_derivatives);
+}
+
 NCLayers layer_allocate(size_t number_of_layers)
 {
     NCLayers result;
 
     result.layers_amount = number_of_layers;
-    result.matrices = malloc(sizeof(*result.matrices) * number_of_layers);
+    result.matrices = NC_MALLOC(sizeof(*result.matrices) * number_of_layers, "perceptron");
     result.activations = activations_allocate(number_of_layers);
 
     assert(result.matrices != NULL);
@@ -111,6 +140,7 @@ void layer_initialize(NCLayers layers, const size_t* neurons, NCActivations stru
 
         layers.matrices[i] = matrix;
         layers.activations.activations[i] = structure.activations[i];
+        layers.activations.activations_derivatives[i] = structure.activations_derivatives[i];
     }
 }
 
@@ -128,11 +158,18 @@ function_type layer_activation_at(NCLayers layers, size_t index)
     return layers.activations.activations[index];
 }
 
+function_type layer_activation_derivative_at(NCLayers layers, size_t index)
+{
+    assert((index < layers.layers_amount) && "Layer Activation derivative out of bounds!");
+
+    return layers.activations.activations_derivatives[index];
+}
+
 void layer_set_data_at(NCLayers layers, size_t index, NCMatrix data)
 {
     assert((layers.matrices[index].columns == data.columns && layers.matrices[index].rows == data.rows) && "Layer Matrix and given Matrix are incompatible");
 
-    layers.matrices[index] = data;
+    matrix_copy(layers.matrices[index], data);
 }
 
 size_t layer_at_length(NCLayers layers, size_t index)
@@ -148,6 +185,71 @@ void layer_print(NCLayers layers)
     }
 }
 
+void layer_delete(NCLayers layers)
+{
+    for (size_t i = 0; i < layers.layers_amount; ++i)
+    {
+        matrix_delete(layers.matrices[i]);
+    }
+
+    NC_FREE(layers.matrices);
+    activations_delete(layers.activations);
+}
+
+NCParameters parameters_allocate(size_t number_of_layers, const size_t* neurons)
+{
+    NCParameters parameters;
+    size_t alignment = PARAMETERS_ALIGNMENT / sizeof(double);
+
+    parameters.weights_amount = number_of_layers - 1;
+    parameters.length = 0;
+    parameters.offsets = NC_MALLOC(sizeof(*parameters.offsets) * parameters.weights_amount, "perceptron");
+
+    assert(parameters.offsets != NULL);
+
+    for (size_t i = 0; i < parameters.weights_amount; ++i)
+    {
+        parameters.offsets[i] = parameters.length;
+        parameters.length += (neurons[i] * neurons[i + 1] + alignment - 1) / alignment * alignment;
+    }
+
+    parameters.numbers = NC_ALIGNED_ALLOC(PARAMETERS_ALIGNMENT, sizeof(*parameters.numbers) * PARAMETERS_SECTIONS * parameters.length, "perceptron");
+
+    assert(parameters.numbers != NULL);
+
+    memset(parameters.numbers, 0, sizeof(*parameters.numbers) * PARAMETERS_SECTIONS * parameters.length);
+
+    return parameters;
+}
+
+NCVector parameters_section(NCParameters parameters, NCParametersSection section)
+{
+    assert((section < PARAMETERS_SECTIONS) && "Parameters section out of bounds!");
+
+    NCVector vector = { parameters.length, parameters.numbers + section * parameters.length };
+
+    return vector;
+}
+
+NCMatrix parameters_matrix_at(NCParameters parameters, NCParametersSection section, size_t index, size_t rows, size_t columns)
+{
+    assert((index < parameters.weights_amount) && "Parameters Weight index out of bounds!");
+
+    size_t end = index + 1 < parameters.weights_amount ? parameters.offsets[index + 1] : parameters.length;
+
+    assert((rows * columns <= end - parameters.offsets[index]) && "Matrix does not fit the Weight storage!");
+
+    NCMatrix matrix = { columns, rows, parameters_section(parameters, section).numbers + parameters.offsets[index] };
+
+    return matrix;
+}
+
+void parameters_delete(NCParameters parameters)
+{
+    NC_FREE(parameters.offsets);
+    NC_FREE(parameters.numbers);
+}
+
 NCPerceptron perceptron_allocate(size_t number_of_layers, const size_t *neurons, NCActivations structure)
 {
     NCPerceptron result;
@@ -155,16 +257,27 @@ NCPerceptron perceptron_allocate(size_t number_of_layers, const size_t *neurons,
     result.layers = layer_allocate(number_of_layers);
     layer_initialize(result.layers, neurons, structure);
 
+    result.parameters = parameters_allocate(number_of_layers, neurons);
+
     NCMatrix matrices[number_of_layers - 1];
 
     for (size_t i = 0; i < number_of_layers - 1; ++i)
     {
-        matrices[i] = matrix_allocate(neurons[i], neurons[i + 1]);
+        matrices[i] = parameters_matrix_at(result.parameters, PARAMETERS_WEIGHTS, i, neurons[i], neurons[i + 1]);
         matrix_random(matrices[i]);
     }
 
     result.weights = weights_allocate(number_of_layers - 1);
     weights_initialize(result.weights, matrices, number_of_layers - 1);
+    result.weights.owns_matrices = 0;
+
+    result.kernels = NC_MALLOC(sizeof(*result.kernels) * (number_of_layers - 1), "perceptron");
+    assert(result.kernels != NULL);
+
+    for (size_t i = 0; i < number_of_layers - 1; ++i)
+    {
+        result.kernels[i] = kernel_bind(neurons[i], neurons[i + 1]);
+    }
 
     return result;
 }
@@ -210,11 +323,179 @@ function_type perceptron_activation_at(NCPerceptron model, size_t index)
     return layer_activation_at(model.layers, index);
 }
 
+function_type perceptron_activation_derivative_at(NCPerceptron model, size_t index)
+{
+    assert(index < perceptron_number_of_layers(model) && "Perceptron model Activation derivative index out of bounds!");
+
+    return layer_activation_derivative_at(model.layers, index);
+}
+
 size_t perceptron_number_of_layers(NCPerceptron model)
 {
     return model.layers.layers_amount;
 }
 
+void perceptron_delete(NCPerceptron model)
+{
+    layer_delete(model.layers);
+    NC_FREE(model.weights.matrices);
+    parameters_delete(model.parameters);
+    NC_FREE(model.kernels);
+}
+
+NCVector perceptron_parameters(NCPerceptron model, NCParametersSection section)
+{
+    return parameters_section(model.parameters, section);
+}
+
+NCMatrix perceptron_parameter_at(NCPerceptron model, NCParametersSection section, size_t index)
+{
+    NCMatrix weight = perceptron_weight_at(model, index);
+
+    return parameters_matrix_at(model.parameters, section, index, weight.rows, weight.columns);
+}
+
+int perceptron_save(NCPerceptron model, const char* path)
+{
+    size_t layers_amount = perceptron_number_of_layers(model);
+
+    FILE* file = fopen(path, "wb");
+
+    if (file == NULL)
+    {
+        perror("perceptron_save: fopen");
+        return -1;
+    }
+
+    NCCheckpointHeader header;
+    uint64_t neurons[layers_amount];
+
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, CHECKPOINT_MAGIC, sizeof(header.magic));
+    header.layers_amount = layers_amount;
+    header.length = model.parameters.length;
+
+    for (size_t i = 0; i < layers_amount; ++i)
+    {
+        neurons[i] = layer_at_length(model.layers, i);
+    }
+
+    size_t numbers = PARAMETERS_SECTIONS * model.parameters.length;
+
+    int written = fwrite(&header, sizeof(header), 1, file) == 1 &&
+                  fwrite(neurons, sizeof(*neurons), layers_amount, file) == layers_amount &&
+                  fwrite(model.parameters.numbers, sizeof(*model.parameters.numbers), numbers, file) == numbers;
+
+    if (fclose(file) != 0 || !written)
+    {
+        fprintf(stderr, "perceptron_save: cannot write %s\n", path);
+        return -1;
+    }
+
+    return 0;
+}
+
+int perceptron_load(NCPerceptron model, const char* path)
+{
+    size_t layers_amount = perceptron_number_of_layers(model);
+
+    FILE* file = fopen(path, "rb");
+
+    if (file == NULL)
+    {
+        perror("perceptron_load: fopen");
+        return -1;
+    }
+
+    NCCheckpointHeader header;
+    uint64_t neurons[layers_amount];
+
+    int compatible = fread(&header, sizeof(header), 1, file) == 1 &&
+                     memcmp(header.magic, CHECKPOINT_MAGIC, sizeof(header.magic)) == 0 &&
+                     header.layers_amount == layers_amount &&
+                     header.length == model.parameters.length &&
+                     fread(neurons, sizeof(*neurons), layers_amount, file) == layers_amount;
+
+    for (size_t i = 0; compatible && i < layers_amount; ++i)
+    {
+        compatible = neurons[i] == layer_at_length(model.layers, i);
+    }
+
+    if (!compatible)
+    {
+        fprintf(stderr, "perceptron_load: %s is not a checkpoint of this model\n", path);
+        fclose(file);
+        return -1;
+    }
+
+    size_t numbers = PARAMETERS_SECTIONS * model.parameters.length;
+    int read = fread(model.parameters.numbers, sizeof(*model.parameters.numbers), numbers, file) == numbers;
+
+    fclose(file);
+
+    if (!read)
+    {
+        fprintf(stderr, "perceptron_load: %s is truncated\n", path);
+        return -1;
+    }
+
+    return 0;
+}
+
+#ifdef NUMC_PROFILE
+static double perceptron_forward_flops(NCPerceptron model)
+{
+    double flops = 0;
+
+    for (size_t i = 1; i < perceptron_number_of_layers(model); ++i)
+    {
+        flops += 2.0 * layer_at_length(model.layers, i - 1) * layer_at_length(model.layers, i);
+    }
+
+    return flops;
+}
+#endif // NUMC_PROFILE
+
+void perceptron_forward(NCPerceptron model)
+{
+    size_t layers_amount = perceptron_number_of_layers(model);
+
+    NC_PROFILE_BEGIN("perceptron_forward", perceptron_forward_flops(model), 0);
+
+    for (size_t i = 1; i < layers_amount; ++i)
+    {
+        NCKernel kernel = model.kernels[i - 1];
+
+        kernel.dot(perceptron_layer_at(model, i), perceptron_layer_at(model, i - 1), perceptron_weight_at(model, i - 1));
+        kernel.apply(perceptron_layer_at(model, i), perceptron_activation_at(model, i));
+    }
+
+    NC_PROFILE_END();
+}
+
+void perceptron_forward_batch(NCPerceptron model, const NCMatrix* activations)
+{
+    size_t layers_amount = perceptron_number_of_layers(model);
+
+    for (size_t i = 0; i < layers_amount; ++i)
+    {
+        assert((activations[i].rows == activations[0].rows) && "Batch Matrices must have the same amount of rows!");
+        assert((activations[i].columns == layer_at_length(model.layers, i)) && "Batch Matrix columns and Layer length are incompatible");
+    }
+
+    NC_PROFILE_BEGIN("perceptron_forward_batch", activations[0].rows * perceptron_forward_flops(model), 0);
+
+    for (size_t i = 1; i < layers_amount; ++i)
+    {
+        NCKernel kernel = model.kernels[i - 1];
+
+        kernel.dot(activations[i], activations[i - 1], perceptron_weight_at(model, i - 1));
+        kernel.apply(activations[i], perceptron_activation_at(model, i));
+    }
+
+    NC_PROFILE_END();
+}
+
 void perceptron_train(NCPerceptron model, NCMatrix* train, size_t train_amount, NCMatrix* labels, size_t labels_amount)
 {
     assert((train_amount == labels_amount) && "Train data samples amount must be the same as Labels amount");
@@ -239,12 +520,7 @@ void perceptron_train(NCPerceptron model, NCMatrix* train, size_t train_amount,
 
         for (size_t epoch = 0; epoch < 100; ++epoch)
         {
-            for (size_t i = 1; i < layers_amount; ++i)
-            {
-                matrix_dot(perceptron_layer_at(model, i), perceptron_layer_at(model, i - 1), perceptron_weight_at(model, i - 1));
-//                layer_set_data_at(before_activation, i, perceptron_layer_at(model, i));
-                apply_to_matrix(perceptron_layer_at(model, i), perceptron_activation_at(model, i));
-            }
+            perceptron_forward(model);
 
             error = mean_squared_error(perceptron_layer_at(model, layers_amount - 1), labels[sample_index]);
 
@@ -261,17 +537,204 @@ double activation_leaky_relu(double x) { return fmax(0.01 * x, x); }
 
 double activation_leaky_relu_derivative(double x) { return x < 0 ? 0.01 : 1; }
 
+// branch-free exp over an array: x = k ln2 + r, e^r by a degree 12 polynomial, 2^k built in the exponent bits
+static void exp_array(double* destination, const double* source, size_t length)
+{
+    const double shifter = 0x1.8p52;
+
+    for (size_t i = 0; i < length; ++i)
+    {
+        double x = source[i];
+
+        x = x < -708.0 ? -708.0 : x;
+        x = x > 709.0 ? 709.0 : x;
+
+        double rounded = x * 1.4426950408889634 + shifter;
+        double k = rounded - shifter;
+        double r = x - k * 6.93147180369123816490e-01 - k * 1.90821492927058770002e-10;
+
+        double p = 1.0 / 479001600.0;
+        p = p * r + 1.0 / 39916800.0;
+        p = p * r + 1.0 / 3628800.0;
+        p = p * r + 1.0 / 362880.0;
+        p = p * r + 1.0 / 40320.0;
+        p = p * r + 1.0 / 5040.0;
+        p = p * r + 1.0 / 720.0;
+        p = p * r + 1.0 / 120.0;
+        p = p * r + 1.0 / 24.0;
+        p = p * r + 1.0 / 6.0;
+        p = p * r + 0.5;
+        p = p * r + 1.0;
+        p = p * r + 1.0;
+
+        unsigned long long bits;
+        memcpy(&bits, &rounded, sizeof(bits));
+        bits = (bits + 1023ULL) << 52;
+
+        double scale;
+        memcpy(&scale, &bits, sizeof(scale));
+
+        destination[i] = p * scale;
+    }
+}
+
+static double row_maximum(const double* row, size_t length)
+{
+    double maximum = row[0];
+
+    for (size_t j = 1; j < length; ++j)
+    {
+        maximum = row[j] > maximum ? row[j] : maximum;
+    }
+
+    return maximum;
+}
+
+// writes exp(row - shift) into destination and returns its sum
+static double row_exp_sum(double* destination, const double* row, size_t length, double shift)
+{
+    double sum = 0;
+
+    for (size_t j = 0; j < length; ++j)
+    {
+        destination[j] = row[j] - shift;
+    }
+
+    exp_array(destination, destination, length);
+
+    for (size_t j = 0; j < length; ++j)
+    {
+        sum += destination[j];
+    }
+
+    return sum;
+}
+
+// sum of exp(row - shift) without storing the exponents
+static double row_exp_sum_discard(const double* row, size_t length, double shift)
+{
+    double chunk[SOFTMAX_CHUNK];
+    double sum = 0;
+
+    for (size_t start = 0; start < length; start += SOFTMAX_CHUNK)
+    {
+        size_t amount = start + SOFTMAX_CHUNK < length ? SOFTMAX_CHUNK : length - start;
+
+        sum += row_exp_sum(chunk, row + start, amount, shift);
+    }
+
+    return sum;
+}
+
+void activation_softmax_to(NCMatrix destination, NCMatrix matrix)
+{
+    assert((destination.rows == matrix.rows && destination.columns == matrix.columns) && "Destination and Matrix dimensions must be the same!");
+
+    NC_PROFILE_BEGIN("activation_softmax", 4.0 * matrix.rows * matrix.columns, 2 * sizeof(double) * matrix.rows * matrix.columns);
+
+    for (size_t i = 0; i < matrix.rows; ++i)
+    {
+        const double* row = &MAT_AT(matrix, i, 0);
+        double* output = &MAT_AT(destination, i, 0);
+
+        double sum = row_exp_sum(output, row, matrix.columns, row_maximum(row, matrix.columns));
+        double scale = 1.0 / sum;
+
+        for (size_t j = 0; j < matrix.columns; ++j)
+        {
+            output[j] *= scale;
+        }
+    }
+
+    NC_PROFILE_END();
+}
+
+void activation_softmax_inplace(NCMatrix matrix)
+{
+    activation_softmax_to(matrix, matrix);
+}
+
 NCMatrix activation_softmax(NCMatrix matrix)
 {
     NCMatrix result = matrix_allocate(matrix.rows, matrix.columns);
-    matrix_copy(result, matrix);
 
-    apply_to_matrix(result, exp);
-    matrix_scale(result, 1 / matrix_sum_of_values(result));
+    activation_softmax_to(result, matrix);
 
     return result;
 }
 
+void activation_log_softmax(NCMatrix destination, NCMatrix matrix)
+{
+    assert((destination.rows == matrix.rows && destination.columns == matrix.columns) && "Destination and Matrix dimensions must be the same!");
+
+    for (size_t i = 0; i < matrix.rows; ++i)
+    {
+        const double* row = &MAT_AT(matrix, i, 0);
+        double* output = &MAT_AT(destination, i, 0);
+
+        double maximum = row_maximum(row, matrix.columns);
+        double normalizer = maximum + log(row_exp_sum_discard(row, matrix.columns, maximum));
+
+        for (size_t j = 0; j < matrix.columns; ++j)
+        {
+            output[j] = row[j] - normalizer;
+        }
+    }
+}
+
+double softmax_cross_entropy(NCMatrix gradient, NCMatrix logits, NCMatrix labels)
+{
+    assert((logits.rows == labels.rows && logits.columns == labels.columns) && "Logits and Labels dimensions must be the same!");
+    assert((gradient.numbers == NULL || (gradient.rows == logits.rows && gradient.columns == logits.columns)) && "Gradient and Logits dimensions must be the same!");
+
+    NC_PROFILE_BEGIN("softmax_cross_entropy", 5.0 * logits.rows * logits.columns, 3 * sizeof(double) * logits.rows * logits.columns);
+
+    double loss = 0;
+
+    for (size_t i = 0; i < logits.rows; ++i)
+    {
+        const double* row = &MAT_AT(logits, i, 0);
+        const double* label = &MAT_AT(labels, i, 0);
+
+        double maximum = row[0];
+        double label_sum = 0;
+        double label_dot = 0;
+
+        for (size_t j = 0; j < logits.columns; ++j)
+        {
+            maximum = row[j] > maximum ? row[j] : maximum;
+            label_sum += label[j];
+            label_dot += label[j] * row[j];
+        }
+
+        double sum;
+
+        if (gradient.numbers == NULL)
+        {
+            sum = row_exp_sum_discard(row, logits.columns, maximum);
+        }
+        else
+        {
+            double* output = &MAT_AT(gradient, i, 0);
+            sum = row_exp_sum(output, row, logits.columns, maximum);
+
+            double scale = 1.0 / sum;
+
+            for (size_t j = 0; j < logits.columns; ++j)
+            {
+                output[j] = output[j] * scale * label_sum - label[j];
+            }
+        }
+
+        // -sum y log p = ( max + log sum e^(x - max) ) sum y - y . x
+        loss += (maximum + log(sum)) * label_sum - label_dot;
+    }
+
+    NC_PROFILE_END();
+
+    return loss;
+}
+
 double mean_squared_error(NCMatrix predicted, NCMatrix real)
 {
     assert(predicted.rows == real.rows && "Predicted and True row lengths must be the same!");
@@ -10,8 +10,10 @@
 
 #include "ncmatrix.h"
 #include "ncvector.h"
+#include "nckernels.h"
 
 #define INITIALIZER_AT(initializer, columns, i, j) (initializer)[(i) * (columns) + (j)]
+#define PARAMETERS_ALIGNMENT 64 // byte alignment of the parameter buffer and of every Weight inside it
 
 /*
  *
@@ -26,7 +28,8 @@ typedef struct
 {
     size_t weights_amount;
     NCMatrix* matrices;
-} NCWeights; // NumC Weights structure that contain: numbers of weights matrices and matrices themselves
+    int owns_matrices;
+} NCWeights; // NumC Weights structure that contain: numbers of weights matrices, matrices themselves and whether deleting the weights deletes the matrices
 
 typedef struct
 {
@@ -42,42 +45,81 @@ typedef struct
     NCActivations activations;
 } NCLayers; // NumC Layer structure that contain: number of neurons in Layer and data Vector
 
+typedef enum
+{
+    PARAMETERS_WEIGHTS,
+    PARAMETERS_GRADIENTS,
+    PARAMETERS_VELOCITIES,
+    PARAMETERS_SECTIONS
+} NCParametersSection; // NumC Parameters section enumeration: Weights, their gradients, their momentum velocities, amount of sections
+
+typedef struct
+{
+    size_t weights_amount;
+    size_t length;
+    size_t* offsets;
+    double* numbers;
+} NCParameters; // NumC Parameters structure that contain: amount of Weights, numbers in one section, offset of each Weight inside a section and one aligned buffer holding every section
+
 typedef struct
 {
     NCLayers layers;
     NCWeights weights;
-} NCPerceptron; // NumC Perceptron model structure that contain: model Layers, model Weights
+    NCParameters parameters;
+    NCKernel* kernels;
+} NCPerceptron; // NumC Perceptron model structure that contain: model Layers, model Weights viewing into the parameter buffer, the buffer itself, kernels bound to each Weight shape
 
 NCWeights weights_allocate(size_t initializer_size); // allocates in memory a weights object and returns NCModel structure
 void weights_initialize(NCWeights weights, const NCMatrix* initializer_list, size_t initializer_size); // initialize a weights layers with Matrices
 NCMatrix weights_at(NCWeights weights, size_t position); // returns a layer at given position
 void weights_print(NCWeights weights); // print the weights
+void weights_delete(NCWeights weights); // deletes a standalone weights object and the Matrices it was initialized with, asserts on the Weights of a Perceptron, which view its parameter buffer
 
 NCActivations activations_allocate(size_t number_of_activations); // ...
 void activations_initialize(NCActivations structure, function_type* activations, function_type* activation_derivatives); // ...
+void activations_delete(NCActivations structure); // deletes an activations object made by activations_allocate
 
 NCLayers layer_allocate(size_t number_of_layers); // allocates in memory a Layer objects
 void layer_initialize(NCLayers layers, const size_t* neurons, NCActivations structure); // Initialize a Layers, with lengths from neurons array, by 0.0 and given functions
-void layer_set_data_at(NCLayers layers, size_t index, NCMatrix data); // Sets a data Matrix at given Layer position
+void layer_set_data_at(NCLayers layers, size_t index, NCMatrix data); // Copies a data Matrix into given Layer position
 function_type layer_activation_at(NCLayers layers, size_t index); // returns an Activation of given Layer
+function_type layer_activation_derivative_at(NCLayers layers, size_t index); // returns an Activation derivative of given Layer
 NCMatrix layer_at(NCLayers layers, size_t index); // returns a Layer Matrix at given index
 size_t layer_at_length(NCLayers layers, size_t index); // returns a length of Layer Matrix at given index
 void layer_print(NCLayers layers); // prints all layers
+void layer_delete(NCLayers layers); // deletes Layer objects and their Matrices
+
+NCParameters parameters_allocate(size_t number_of_layers, const size_t* neurons); // allocates one zero-filled aligned buffer for the Weights between given Layers, their gradients and optimizer state
+NCVector parameters_section(NCParameters parameters, NCParametersSection section); // returns a flat Vector view of a whole section, padding between Weights included
+NCMatrix parameters_matrix_at(NCParameters parameters, NCParametersSection section, size_t index, size_t rows, size_t columns); // returns a ( rows x columns ) Matrix view of Weight index inside a section
+void parameters_delete(NCParameters parameters); // deletes the parameter buffer
 
 NCPerceptron perceptron_allocate(size_t number_of_layers, const size_t* neurons, NCActivations structure); // allocates in memory a Perceptron model object with given number of layers and activation functions, weight allocates and initialize with random numbers automatically
-void perceptron_set_input(NCPerceptron model, NCMatrix input_data); // sets an input data
+void perceptron_set_input(NCPerceptron model, NCMatrix input_data); // copies an input data into the input Layer
 void perceptron_print(NCPerceptron model); // prints a given Perceptron model
 NCMatrix perceptron_layer_at(NCPerceptron model, size_t index); // returns a Perceptron Layer Matrix at given index
 NCMatrix perceptron_weight_at(NCPerceptron model, size_t index); // returns a Perceptron Weight Matrix at given index
 function_type perceptron_activation_at(NCPerceptron model, size_t index); // returns an activation function of Layer at given index
+function_type perceptron_activation_derivative_at(NCPerceptron model, size_t index); // returns an activation function derivative of Layer at given index
 size_t perceptron_number_of_layers(NCPerceptron model); // returns a Perceptron Layers number
+void perceptron_delete(NCPerceptron model); // deletes a Perceptron model with its Layers, Weights and kernels
+NCVector perceptron_parameters(NCPerceptron model, NCParametersSection section); // returns a flat Vector view of one section of all model parameters
+NCMatrix perceptron_parameter_at(NCPerceptron model, NCParametersSection section, size_t index); // returns a view of Weight index inside a section, shaped like the Weight
+int perceptron_save(NCPerceptron model, const char* path); // writes Layer lengths and every parameter section to a checkpoint file, returns 0 on success
+int perceptron_load(NCPerceptron model, const char* path); // reads a checkpoint of a model with the same Layer lengths into every parameter section, returns 0 on success, a truncated file leaves it partially read
+void perceptron_forward(NCPerceptron model); // propagates the input Layer through all Weights and activations
+void perceptron_forward_batch(NCPerceptron model, const NCMatrix* activations); // propagates a batch through the model, activations[i] is a (batch x neurons[i]) Matrix and activations[0] holds the input rows
 void perceptron_train(NCPerceptron model, NCMatrix* train, size_t train_amount, NCMatrix* labels, size_t labels_amount); // forwarding a model
 
 double activation_identity(double x); // returns a same number
 double activation_identity_derivative(double x); // identity activation function derivative
 double activation_leaky_relu(double x); // leaky ReLU activation function
 double activation_leaky_relu_derivative(double x); // leaky ReLU activation function derivative
-NCMatrix activation_softmax(NCMatrix matrix); // returns a softmax Matrix
+NCMatrix activation_softmax(NCMatrix matrix); // returns a new Matrix with row-wise softmax of given Matrix
+void activation_softmax_inplace(NCMatrix matrix); // numerically stable row-wise softmax in-place
+void activation_softmax_to(NCMatrix destination, NCMatrix matrix); // puts a numerically stable row-wise softmax of Matrix into destination
+void activation_log_softmax(NCMatrix destination, NCMatrix matrix); // puts a row-wise log-softmax of Matrix into destination, destination may be the same Matrix
+double softmax_cross_entropy(NCMatrix gradient, NCMatrix logits, NCMatrix labels); // returns a cross-entropy of softmax(logits) against labels summed over rows, writes d(loss)/d(logits) into gradient unless gradient.numbers is NULL, gradient may be logits
 double mean_squared_error(NCMatrix predicted, NCMatrix real); // returns a mean squared error
 double mean_squared_error_derivative(NCMatrix predicted, NCMatrix real);
 
@@ -0,0 +1,58 @@
+#include <stdlib.h>
+
+#include "Source/ncserver.h"
+
+#define LOADGEN_SOCKET "/tmp/numc-loadgen.sock"
+#define LOADGEN_LAYERS 4
+
+// usage: NumCLoadGen [clients] [in flight per client] [requests per client] [socket path]
+int main(int argc, char** argv)
+{
+    size_t clients = argc > 1 ? strtoul(argv[1], NULL, 10) : 8;
+    size_t in_flight = argc > 2 ? strtoul(argv[2], NULL, 10) : 8;
+    size_t requests = argc > 3 ? strtoul(argv[3], NULL, 10) : 20000;
+    const char* socket_path = argc > 4 ? argv[4] : LOADGEN_SOCKET;
+
+    size_t neurons[LOADGEN_LAYERS] = { 32, 64, 64, 8 };
+    function_type activations[LOADGEN_LAYERS] = { activation_identity, activation_leaky_relu, activation_leaky_relu, activation_identity };
+    function_type derivatives[LOADGEN_LAYERS] = { activation_identity_derivative, activation_leaky_relu_derivative, activation_leaky_relu_derivative, activation_identity_derivative };
+
+    NCActivations structure = { LOADGEN_LAYERS, activations, derivatives };
+    NCPerceptron model = perceptron_allocate(LOADGEN_LAYERS, neurons, structure);
+
+    size_t batch_sizes[] = { 1, 8, 32, 128 };
+    size_t waits[] = { 0, 200, 1000 };
+
+    printf("%zu clients x %zu in flight x %zu requests, model 32-64-64-8\n\n", clients, in_flight, requests);
+    printf("%10s %10s %12s %12s %10s %10s %10s\n", "max batch", "wait us", "req/s", "mean batch", "p50 us", "p99 us", "max us");
+
+    for (size_t i = 0; i < sizeof(batch_sizes) / sizeof(*batch_sizes); ++i)
+    {
+        for (size_t j = 0; j < sizeof(waits) / sizeof(*waits); ++j)
+        {
+            NCServerConfig config = { socket_path, batch_sizes[i], waits[j], 2, 0 };
+            NCServer* server = server_start(model, config);
+
+            if (server == NULL)
+            {
+                return 1;
+            }
+
+            NCLoadConfig load = { socket_path, clients, requests, in_flight, neurons[0], neurons[LOADGEN_LAYERS - 1] };
+            NCServerStats client = server_load_generate(load);
+            NCServerStats served = server_stats(server);
+
+            server_stop(server);
+
+            printf("%10zu %10zu %12.0f %12.2f %10.0f %10.0f %10.0f\n",
+                   batch_sizes[i], waits[j], client.throughput, served.mean_batch_size,
+                   client.p50_microseconds, client.p99_microseconds, client.max_microseconds);
+        }
+    }
+
+    perceptron_delete(model);
+
+    NC_MEMORY_PRINT_SUMMARY();
+
+    return 0;
+}